@@ -32,7 +32,7 @@
  * compatible, thus CINDEX_VERSION_MAJOR is expected to remain stable.
  */
 #define CINDEX_VERSION_MAJOR 0
-#define CINDEX_VERSION_MINOR 43
+#define CINDEX_VERSION_MINOR 46
 
 #define CINDEX_VERSION_ENCODE(major, minor) ( \
       ((major) * 10000)                       \
@@ -1292,7 +1292,51 @@ enum CXTranslationUnit_Flags {
   /**
    * \brief Sets the preprocessor in a mode for parsing a single file only.
    */
-  CXTranslationUnit_SingleFileParse = 0x400
+  CXTranslationUnit_SingleFileParse = 0x400,
+
+  /**
+   * \brief Used to indicate that reparsing may skip the bodies of top-level
+   * functions in the main file that are unaffected by the changes made since
+   * the last parse.
+   *
+   * A body is only skipped when all of the changes to the main file lie within
+   * one other function body, no other file has changed, and the body produced
+   * no diagnostics and used no internal declarations or template
+   * specializations. Bodies after the edited one are only skipped when the
+   * edit adds or removes no preprocessor directives and does not shift the
+   * lines that follow it.
+   *
+   * This trades completeness for reparse latency. As with
+   * \c CXTranslationUnit_SkipFunctionBodies, the skipped bodies are not
+   * present in the reparsed translation unit: cursors, references and other
+   * queries inside them find nothing until the next full parse. Only use this
+   * flag when such queries are limited to the function being edited.
+   */
+  CXTranslationUnit_SkipUnchangedFunctionBodies = 0x800,
+
+  /**
+   * \brief Used to indicate that an out-of-date precompiled preamble should be
+   * rebuilt in the background.
+   *
+   * When only the headers included by the preamble have changed, and each of
+   * them kept its size, reparsing and code completion keep using the
+   * previous preamble until the new one has been built, instead of waiting
+   * for it. Other changes still rebuild the preamble before reparsing. Until
+   * the new preamble is used, locations in the changed headers may refer to
+   * their previous contents. This option only has an effect
+   * together with \c CXTranslationUnit_PrecompiledPreamble.
+   */
+  CXTranslationUnit_BuildPreambleInBackground = 0x1000,
+
+  /**
+   * \brief Used to indicate that the precompiled preamble should be kept in
+   * memory, rather than written to a temporary file and read back from it.
+   *
+   * This avoids the file system I/O when the preamble is built and every time
+   * it is reused, at the cost of keeping the preamble in memory. This option
+   * only has an effect together with \c CXTranslationUnit_PrecompiledPreamble.
+   */
+  CXTranslationUnit_StorePreambleInMemory = 0x2000
 };
 
 /**
@@ -192,7 +192,9 @@ class ASTContext : public RefCountedBase<ASTContext> {
 
   /// \brief A cache mapping from RecordDecls to ASTRecordLayouts.
   ///
-  /// This is lazily created.  This is intentionally not serialized.
+  /// This is lazily created.  The layouts of records declared in an AST file
+  /// are serialized along with it, and loaded back on demand through the
+  /// external AST source.
   mutable llvm::DenseMap<const RecordDecl*, const ASTRecordLayout*>
     ASTRecordLayouts;
   mutable llvm::DenseMap<const ObjCContainerDecl*, const ASTRecordLayout*>
@@ -202,6 +204,16 @@ class ASTContext : public RefCountedBase<ASTContext> {
   typedef llvm::DenseMap<const Type *, struct TypeInfo> TypeInfoMap;
   mutable TypeInfoMap MemoizedTypeInfo;
 
+  /// \brief A cache of the results of calls to constexpr functions whose
+  /// parameters and result are all integral, keyed by an encoding of the
+  /// callee and the argument values built by the constant evaluator.
+  ///
+  /// This is lazily populated and bounded by the ConstexprCacheEntries
+  /// language option.
+  llvm::StringMap<llvm::APSInt> ConstexprCallResults;
+  mutable unsigned NumConstexprCallCacheHits = 0;
+  mutable unsigned NumConstexprCallCacheMisses = 0;
+
   /// \brief A cache mapping from CXXRecordDecls to key functions.
   llvm::DenseMap<const CXXRecordDecl*, LazyDeclPtr> KeyFunctions;
 
@@ -1029,8 +1041,30 @@ public:
   ASTMutationListener *getASTMutationListener() const { return Listener; }
 
   void PrintStats() const;
+
+  /// \brief Write the memory used by the AST as JSON, broken down by type,
+  /// declaration and statement kind, and by the file that the declarations
+  /// and statements come from.
+  ///
+  /// The per-kind and per-file numbers are estimates summed from the sizes of
+  /// the node classes, and only cover declarations that were not loaded from
+  /// an AST file. This walks the local AST, so it is only meant for diagnosing
+  /// the memory footprint of a translation unit.
+  void PrintStatsJSON(raw_ostream &OS) const;
   const SmallVectorImpl<Type *>& getTypes() const { return Types; }
 
+  /// \brief Retrieve the cached result of a call to a constexpr function.
+  ///
+  /// \param Key The encoding of the callee and its argument values, as
+  /// built by the constant evaluator.
+  ///
+  /// \returns the cached result, or null if the call has not been cached.
+  const llvm::APSInt *getConstexprCallResult(StringRef Key) const;
+
+  /// \brief Cache the result of a call to a constexpr function, unless the
+  /// cache is full.
+  void setConstexprCallResult(StringRef Key, const llvm::APSInt &Result);
+
   BuiltinTemplateDecl *buildBuiltinTemplateDecl(BuiltinTemplateKind BTK,
                                                 const IdentifierInfo *II) const;
 
@@ -646,6 +646,15 @@ public:
                              const VarDecl *VD,
                              SmallVectorImpl<PartialDiagnosticAt> &Notes) const;
 
+  /// EvaluateAsStaticInitializer - Evaluate an expression as the initializer
+  /// of the given variable of static or thread storage duration, for which
+  /// C++ [basic.start.static]p3 permits static initialization in place of
+  /// dynamic initialization. Unlike EvaluateAsInitializer, calls to functions
+  /// that are not constexpr are evaluated if their definitions are available.
+  /// Returns true if the initializer can be folded to a constant.
+  bool EvaluateAsStaticInitializer(APValue &Result, const ASTContext &Ctx,
+                                   const VarDecl *VD) const;
+
   /// EvaluateWithSubstitution - Evaluate an expression as if from the context
   /// of a call to the given function with the given arguments, inside an
   /// unevaluated context. Returns true if the expression could be folded to a
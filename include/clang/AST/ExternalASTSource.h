@@ -22,6 +22,7 @@
 namespace clang {
 
 class ASTConsumer;
+class ASTRecordLayout;
 class CXXBaseSpecifier;
 class CXXCtorInitializer;
 class DeclarationName;
@@ -280,6 +281,14 @@ public:
       llvm::DenseMap<const CXXRecordDecl *, CharUnits> &BaseOffsets,
       llvm::DenseMap<const CXXRecordDecl *, CharUnits> &VirtualBaseOffsets);
 
+  /// \brief Retrieve the layout of the given record, as computed when the
+  /// external source was built.
+  ///
+  /// \returns the layout, allocated in the AST context, or null if the
+  /// external source has no layout for this record.
+  virtual const ASTRecordLayout *
+  getSerializedRecordLayout(const RecordDecl *Record);
+
   //===--------------------------------------------------------------------===//
   // Queries for performance analysis.
   //===--------------------------------------------------------------------===//
@@ -31,6 +31,7 @@
 #include "llvm/ADT/StringMap.h"
 #include "llvm/Support/MD5.h"
 #include <cassert>
+#include <future>
 #include <memory>
 #include <string>
 #include <sys/types.h>
@@ -220,6 +221,21 @@ private:
   /// \brief A list of the serialization ID numbers for each of the top-level
   /// declarations parsed within the precompiled preamble.
   std::vector<serialization::DeclID> TopLevelDeclsInPreamble;
+
+  /// \brief Whether an out-of-date preamble is rebuilt on a worker thread
+  /// rather than during the reparse that notices it.
+  bool BuildPreambleInBackground;
+
+  /// \brief Whether precompiled preambles are kept in memory rather than in
+  /// temporary files.
+  bool StorePreambleInMemory;
+
+  /// \brief A preamble built on a worker thread, along with the information
+  /// ASTUnit keeps about it.
+  struct BackgroundPreamble;
+
+  /// \brief The preamble being built on a worker thread, if any.
+  std::future<std::unique_ptr<BackgroundPreamble>> PendingPreamble;
   
   /// \brief Whether we should be caching code-completion results.
   bool ShouldCacheCodeCompletionResults : 1;
@@ -231,6 +247,43 @@ private:
   /// \brief True if non-system source files should be treated as volatile
   /// (likely to change while trying to use them).
   bool UserFilesAreVolatile : 1;
+
+  /// \brief Whether a reparse may skip the bodies of the top-level functions
+  /// in the main file that the edits since the last parse cannot affect.
+  bool SkipUnchangedFunctionBodies : 1;
+
+  /// \brief The extent of a top-level function definition in the main file,
+  /// as byte offsets.
+  struct FunctionBodyInfo {
+    /// \brief The offset of the function's name.
+    unsigned NameOffset;
+
+    /// \brief The offsets of the first and last tokens of the body.
+    unsigned BodyBegin, BodyEnd;
+
+    /// \brief Whether any diagnostic was reported within the definition.
+    bool HasDiagnostics;
+
+    /// \brief Whether the body uses declarations with internal linkage or
+    /// template specializations. Skipping it would leave the former looking
+    /// unused and the latter uninstantiated.
+    bool UsesOtherDecls;
+  };
+
+  /// \brief The top-level function definitions in the main file, as of the
+  /// last successful parse, when SkipUnchangedFunctionBodies is set.
+  std::vector<FunctionBodyInfo> MainFileFunctionBodies;
+
+  /// \brief Hashes of the remapped file buffers used by the last parse,
+  /// other than the main file's.
+  llvm::StringMap<size_t> RemappedBufferHashes;
+
+  /// \brief The function definitions whose bodies the current reparse skips,
+  /// keyed by the offset of the function's name in the new main file.
+  llvm::DenseMap<unsigned, FunctionBodyInfo> SkippableFunctionBodies;
+
+  void recordMainFileFunctionBodies();
+  void computeSkippableFunctionBodies(vfs::FileSystem &VFS);
  
   static void ConfigureDiags(IntrusiveRefCntPtr<DiagnosticsEngine> Diags,
                              ASTUnit &AST, bool CaptureDiagnostics);
@@ -358,6 +411,13 @@ private:
       unsigned MaxLines = 0);
   void RealizeTopLevelDeclsFromPreamble();
 
+  void startBackgroundPreambleBuild(
+      std::shared_ptr<PCHContainerOperations> PCHContainerOps,
+      const CompilerInvocation &PreambleInvocationIn,
+      const llvm::MemoryBuffer &MainFileBuffer, PreambleBounds Bounds,
+      IntrusiveRefCntPtr<vfs::FileSystem> VFS);
+  void adoptBackgroundPreamble(BackgroundPreamble &Built);
+
   /// \brief Transfers ownership of the objects (like SourceManager) from
   /// \param CI to this ASTUnit.
   void transferASTDataFromCompilerInstance(CompilerInstance &CI);
@@ -460,6 +520,51 @@ public:
   bool getOwnsRemappedFileBuffers() const { return OwnsRemappedFileBuffers; }
   void setOwnsRemappedFileBuffers(bool val) { OwnsRemappedFileBuffers = val; }
 
+  /// \brief Allow reparses to skip the bodies of the top-level functions in
+  /// the main file that could not have been affected by the edits made since
+  /// the last parse.
+  ///
+  /// A body is only skipped when every edit to the main file falls within a
+  /// single other function body, no other input file has changed, and the
+  /// body neither produced diagnostics nor used internal declarations or
+  /// template specializations when it was last parsed. Bodies after the
+  /// edited one are not skipped either if the edited body contains
+  /// preprocessor directives, before or after the edit, or if the edit adds
+  /// or removes lines.
+  ///
+  /// This trades completeness of the AST for reparse latency, and is off by
+  /// default: the previous AST cannot be kept, since every reparse builds a
+  /// new ASTContext, so skipped bodies have no AST at all, as with
+  /// \c CXTranslationUnit_SkipFunctionBodies. Clients that need cursors,
+  /// references or other AST queries inside unchanged bodies after a reparse
+  /// must not enable it.
+  void setSkipUnchangedFunctionBodies(bool Skip);
+
+  /// \brief Rebuild an out-of-date precompiled preamble on a worker thread.
+  ///
+  /// When only the files included by the preamble have changed, reparses and
+  /// code completion keep using the stale preamble until the new one is
+  /// ready, and it is swapped in at the start of the next reparse. This
+  /// requires every changed file to have kept its size, see
+  /// PrecompiledPreamble::CanServeStale. Otherwise, or when the preamble
+  /// region of the main file itself changes, the stale preamble cannot be
+  /// used and the preamble is rebuilt synchronously as usual.
+  void setBuildPreambleInBackground(bool Background);
+
+  /// \brief Wait until the preamble that is being built in the background, if
+  /// any, is ready to be swapped in by the next reparse.
+  void waitForBackgroundPreamble() const;
+
+  /// \brief Keep precompiled preambles built from now on in memory, rather
+  /// than writing them to a temporary file and reading them back.
+  void setStorePreambleInMemory(bool InMemory) {
+    StorePreambleInMemory = InMemory;
+  }
+
+  /// \brief Determine whether the parse in progress should skip the body of
+  /// the given function.
+  bool shouldSkipFunctionBody(const Decl *D) const;
+
   StringRef getMainFileName() const;
 
   /// \brief If this ASTUnit came from an AST file, returns the filename for it.
@@ -758,6 +863,16 @@ public:
   ///
   /// \param ResourceFilesPath - The path to the compiler resource files.
   ///
+  /// \param SkipUnchangedFunctionBodies - Whether reparses skip the bodies of
+  /// functions that did not change, see setSkipUnchangedFunctionBodies().
+  ///
+  /// \param BuildPreambleInBackground - Whether out-of-date preambles are
+  /// rebuilt on a worker thread, see setBuildPreambleInBackground().
+  ///
+  /// \param StorePreambleInMemory - Whether precompiled preambles, including
+  /// the one built by the initial parse, are kept in memory rather than in
+  /// temporary files.
+  ///
   /// \param ModuleFormat - If provided, uses the specific module format.
   ///
   /// \param ErrAST - If non-null and parsing failed without any AST to return
@@ -785,6 +900,9 @@ public:
       bool AllowPCHWithCompilerErrors = false, bool SkipFunctionBodies = false,
       bool SingleFileParse = false,
       bool UserFilesAreVolatile = false, bool ForSerialization = false,
+      bool SkipUnchangedFunctionBodies = false,
+      bool BuildPreambleInBackground = false,
+      bool StorePreambleInMemory = false,
       llvm::Optional<StringRef> ModuleFormat = llvm::None,
       std::unique_ptr<ASTUnit> *ErrAST = nullptr,
       IntrusiveRefCntPtr<vfs::FileSystem> VFS = nullptr);
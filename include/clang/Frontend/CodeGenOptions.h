@@ -204,6 +204,11 @@ public:
   /// the summary and module symbol table (and not, e.g. any debug metadata).
   std::string ThinLinkBitcodeFile;
 
+  /// The output files of the code generation partitions after the first one,
+  /// whose output goes to the main output file. When non-empty, the optimized
+  /// module is split and the partitions are generated concurrently.
+  std::vector<std::string> ParallelCodeGenOutputs;
+
   /// A list of file names passed with -fcuda-include-gpubinary options to
   /// forward to CUDA runtime back-end for incorporating them into host-side
   /// object file.
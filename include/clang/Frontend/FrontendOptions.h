@@ -324,6 +324,9 @@ public:
   /// Filename to write statistics to.
   std::string StatsFile;
 
+  /// Filename to write the AST memory statistics to.
+  std::string ASTStatsFile;
+
 public:
   FrontendOptions() :
     DisableFree(false), RelocatablePCH(false), ShowHelp(false),
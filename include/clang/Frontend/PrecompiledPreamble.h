@@ -85,6 +85,9 @@ public:
   ///
   /// \param PCHContainerOps An instance of PCHContainerOperations.
   ///
+  /// \param StoreInMemory Store the PCH in memory rather than in a temporary
+  /// file on disk.
+  ///
   /// \param Callbacks A set of callbacks to be executed when building
   /// the preamble.
   static llvm::ErrorOr<PrecompiledPreamble>
@@ -92,7 +95,7 @@ public:
         const llvm::MemoryBuffer *MainFileBuffer, PreambleBounds Bounds,
         DiagnosticsEngine &Diagnostics, IntrusiveRefCntPtr<vfs::FileSystem> VFS,
         std::shared_ptr<PCHContainerOperations> PCHContainerOps,
-        PreambleCallbacks &Callbacks);
+        bool StoreInMemory, PreambleCallbacks &Callbacks);
 
   PrecompiledPreamble(PrecompiledPreamble &&) = default;
   PrecompiledPreamble &operator=(PrecompiledPreamble &&) = default;
@@ -106,16 +109,53 @@ public:
                 const llvm::MemoryBuffer *MainFileBuffer, PreambleBounds Bounds,
                 vfs::FileSystem *VFS) const;
 
+  /// Check whether PrecompiledPreamble, though out of date, can still be
+  /// loaded for the new contents (\p MainFileBuffer) of the main file while a
+  /// new one is being built. The preamble region of the main file must be
+  /// unchanged, and every file included by the preamble must have kept its
+  /// size and must still be remapped, or still not be remapped, as when the
+  /// preamble was built. The PCH reader rejects a file whose size changed
+  /// even with validation disabled, and would map the stored source locations
+  /// past the end of a remapped buffer that shrank.
+  bool CanServeStale(const CompilerInvocation &Invocation,
+                     const llvm::MemoryBuffer *MainFileBuffer,
+                     PreambleBounds Bounds, vfs::FileSystem *VFS) const;
+
   /// Changes options inside \p CI to use PCH from this preamble. Also remaps
   /// main file to \p MainFileBuffer.
   void AddImplicitPreamble(CompilerInvocation &CI,
                            llvm::MemoryBuffer *MainFileBuffer) const;
 
+  /// If the PCH is stored in memory, makes it visible to \p Clang, whose file
+  /// manager must already have been set up. The PCH is not copied; the buffer
+  /// added to the memory buffer cache of \p Clang shares ownership of it, so
+  /// it stays valid even if this preamble is rebuilt or destroyed first.
+  void AddInMemoryPCH(CompilerInstance &Clang) const;
+
+  /// Whether the PCH is stored in memory rather than in a file on disk.
+  bool isStoredInMemory() const { return !PCHFile; }
+
 private:
-  PrecompiledPreamble(TempPCHFile PCHFile, std::vector<char> PreambleBytes,
+  PrecompiledPreamble(llvm::Optional<TempPCHFile> PCHFile,
+                      std::string InMemoryPCH, std::vector<char> PreambleBytes,
                       bool PreambleEndsAtStartOfLine,
                       llvm::StringMap<PreambleFileHash> FilesInPreamble);
 
+  /// Check whether the preamble region of \p MainFileBuffer is the one this
+  /// PrecompiledPreamble was built from.
+  bool MatchesMainFile(const llvm::MemoryBuffer *MainFileBuffer,
+                       PreambleBounds Bounds) const;
+
+  /// Check whether the files included by the preamble are unchanged or, if
+  /// \p SizesOnly, whether they only changed in ways that keep the PCH
+  /// loadable (see CanServeStale).
+  bool FilesInPreambleMatch(const CompilerInvocation &Invocation,
+                            vfs::FileSystem *VFS, bool SizesOnly) const;
+
+  /// The path the PCH is read from: either the temporary file, or the name
+  /// the in-memory PCH is made visible under.
+  llvm::StringRef getPCHPath() const;
+
   /// A temp file that would be deleted on destructor call. If destructor is not
   /// called for any reason, the file will be deleted at static objects'
   /// destruction.
@@ -183,8 +223,17 @@ private:
     }
   };
 
-  /// Manages the lifetime of temporary file that stores a PCH.
-  TempPCHFile PCHFile;
+  /// Manages the lifetime of temporary file that stores a PCH, unless the PCH
+  /// is stored in memory.
+  llvm::Optional<TempPCHFile> PCHFile;
+
+  /// The contents of the PCH, when it is stored in memory. Shared with the
+  /// memory buffers handed out by AddInMemoryPCH.
+  std::shared_ptr<const std::string> InMemoryPCH;
+
+  /// The name the in-memory PCH is made visible under. Each preamble gets a
+  /// different name, so that file managers never confuse two of them.
+  std::string InMemoryPCHPath;
   /// Keeps track of the files that were used when computing the
   /// preamble, with both their buffer size and their modification time.
   ///
@@ -137,6 +137,15 @@ public:
   /// regenerated often.
   unsigned ModuleCachePruneAfter;
 
+  /// \brief The maximum size (in bytes) of the module files kept in the
+  /// module cache, or zero for no limit.
+  ///
+  /// When the module cache is pruned and the module files that remain
+  /// after age-based pruning exceed this size, the least recently built or
+  /// validated ones are removed until the cache fits. Module files that are
+  /// locked for building are left alone.
+  uint64_t ModuleCachePruneSizeLimit;
+
   /// \brief The time in seconds when the build session started.
   ///
   /// This time is used by other optimizations in header search and module
@@ -180,16 +189,23 @@ public:
 
   unsigned ModulesHashContent : 1;
 
+  /// \brief Whether to record a content hash for each input file of an AST
+  /// file, and to compare it against the file on disk when the stored size
+  /// matches but the modification time does not.
+  unsigned ValidateASTInputFilesContent : 1;
+
   HeaderSearchOptions(StringRef _Sysroot = "/")
       : Sysroot(_Sysroot), ModuleFormat("raw"), DisableModuleHash(0),
         ImplicitModuleMaps(0), ModuleMapFileHomeIsCwd(0),
         ModuleCachePruneInterval(7 * 24 * 60 * 60),
-        ModuleCachePruneAfter(31 * 24 * 60 * 60), BuildSessionTimestamp(0),
+        ModuleCachePruneAfter(31 * 24 * 60 * 60),
+        ModuleCachePruneSizeLimit(0), BuildSessionTimestamp(0),
         UseBuiltinIncludes(true), UseStandardSystemIncludes(true),
         UseStandardCXXIncludes(true), UseLibcxx(false), Verbose(false),
         ModulesValidateOncePerBuildSession(false),
         ModulesValidateSystemHeaders(false), UseDebugInfo(false),
-        ModulesValidateDiagnosticOptions(true), ModulesHashContent(false) {}
+        ModulesValidateDiagnosticOptions(true), ModulesHashContent(false),
+        ValidateASTInputFilesContent(false) {}
 
   /// AddPath - Add the \p Path path to the specified \p Group list.
   void AddPath(StringRef Path, frontend::IncludeDirGroup Group,
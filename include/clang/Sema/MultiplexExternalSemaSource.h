@@ -185,6 +185,11 @@ public:
                  llvm::DenseMap<const CXXRecordDecl *,
                                 CharUnits> &VirtualBaseOffsets) override;
 
+  /// \brief Retrieve the serialized layout of the given record from the
+  /// first source that has one.
+  const ASTRecordLayout *
+  getSerializedRecordLayout(const RecordDecl *Record) override;
+
   /// Return the amount of memory used by memory buffers, breaking down
   /// by heap-backed versus mmap'ed memory.
   void getMemoryBufferSizes(MemoryBufferSizes &sizes) const override;
@@ -23,6 +23,7 @@
 #include "clang/AST/UnresolvedSet.h"
 #include "clang/Sema/SemaFixItUtils.h"
 #include "clang/Sema/TemplateDeduction.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/AlignOf.h"
@@ -741,6 +742,21 @@ namespace clang {
     // inline to avoid allocation for small sets.
     llvm::BumpPtrAllocator SlabAllocator;
 
+    /// \brief The key identifying a cached argument conversion: the argument,
+    /// the parameter type it is converted to, and the flags that were passed
+    /// to TryCopyInitialization.
+    typedef std::pair<std::pair<const Expr *, QualType>, unsigned>
+        ConversionCacheKey;
+
+    /// \brief Conversion sequences already computed for the arguments of this
+    /// set. Many candidates of a heavily-overloaded function share parameter
+    /// types, so each argument only needs to be converted to each distinct
+    /// parameter type once. Only filled in from the second candidate on, and
+    /// kept inline while it is small, so that sets with few candidates do not
+    /// pay for it.
+    llvm::SmallDenseMap<ConversionCacheKey, ImplicitConversionSequence, 4>
+        ConversionCache;
+
     SourceLocation Loc;
     CandidateSetKind Kind;
 
@@ -797,6 +813,25 @@ namespace clang {
     /// \brief Clear out all of the candidates.
     void clear();
 
+    /// \brief Find the conversion sequence previously computed from the
+    /// argument \p From to \p ToType with the given TryCopyInitialization
+    /// flags, if any.
+    const ImplicitConversionSequence *
+    findCachedConversion(const Expr *From, QualType ToType,
+                         unsigned Flags) const {
+      auto Known = ConversionCache.find(
+          std::make_pair(std::make_pair(From, ToType), Flags));
+      return Known == ConversionCache.end() ? nullptr : &Known->second;
+    }
+
+    /// \brief Remember the conversion sequence from the argument \p From to
+    /// \p ToType computed with the given TryCopyInitialization flags.
+    void cacheConversion(const Expr *From, QualType ToType, unsigned Flags,
+                         const ImplicitConversionSequence &ICS) {
+      ConversionCache[std::make_pair(std::make_pair(From, ToType), Flags)] =
+          ICS;
+    }
+
     typedef SmallVectorImpl<OverloadCandidate>::iterator iterator;
     iterator begin() { return Candidates.begin(); }
     iterator end() { return Candidates.end(); }
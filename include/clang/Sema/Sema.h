@@ -1055,6 +1055,17 @@ public:
   /// \brief The number of SFINAE diagnostics that have been trapped.
   unsigned NumSFINAEErrors;
 
+  /// \brief In -fcompact-type-source-info mode, the type source information
+  /// of the last declarator whose type was written entirely by declaration
+  /// specifiers, and the range of those specifiers. Later declarators of the
+  /// same declaration reuse it.
+  TypeSourceInfo *LastDeclSpecTypeSourceInfo;
+  SourceRange LastDeclSpecTypeSourceInfoRange;
+
+  /// \brief The number of declarators that reused the type source
+  /// information of a previous declarator.
+  unsigned NumSharedTypeSourceInfos;
+
   typedef llvm::DenseMap<ParmVarDecl *, llvm::TinyPtrVector<ParmVarDecl *>>
     UnparsedDefaultArgInstantiationsMap;
 
@@ -36,7 +36,7 @@ namespace clang {
     /// Version 4 of AST files also requires that the version control branch and
     /// revision match exactly, since there is no backward compatibility of
     /// AST files at this time.
-    const unsigned VERSION_MAJOR = 6;
+    const unsigned VERSION_MAJOR = 7;
 
     /// \brief AST file minor version number supported by this version of
     /// Clang.
@@ -347,7 +347,11 @@ namespace clang {
     /// inside the control block.
     enum InputFileRecordTypes {
       /// \brief An input file.
-      INPUT_FILE = 1
+      INPUT_FILE = 1,
+
+      /// \brief The content hash of the preceding input file, or zero if
+      /// the content was not hashed.
+      INPUT_FILE_HASH
     };
 
     /// \brief Record types that occur within the AST block itself.
@@ -610,6 +614,10 @@ namespace clang {
 
       /// \brief The stack of open #ifs/#ifdefs recorded in a preamble.
       PP_CONDITIONAL_STACK = 62,
+
+      /// \brief Record code for the layouts of records declared in this AST
+      /// file that were computed while building it.
+      RECORD_LAYOUTS = 63,
     };
 
     /// \brief Record types used within a source manager block.
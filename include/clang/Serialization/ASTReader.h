@@ -525,6 +525,12 @@ private:
   /// \brief Map from a FileID to the file-level declarations that it contains.
   llvm::DenseMap<FileID, FileDeclsInfo> FileDeclIDs;
 
+  /// \brief Map from the global ID of a record to the module file holding
+  /// its serialized layout and the position of that layout within the
+  /// module file's RecordLayouts.
+  llvm::DenseMap<serialization::DeclID, std::pair<ModuleFile *, unsigned>>
+      RecordLayoutOffsets;
+
   /// \brief An array of lexical contents of a declaration context, as a sequence of
   /// Decl::Kind, DeclID pairs.
   typedef ArrayRef<llvm::support::unaligned_uint32_t> LexicalContents;
@@ -1144,6 +1150,7 @@ private:
     std::string Filename;
     off_t StoredSize;
     time_t StoredTime;
+    uint64_t StoredContentHash;
     bool Overridden;
     bool Transient;
     bool TopLevelModuleMap;
@@ -1870,6 +1877,11 @@ public:
   /// \brief Print some statistics about AST usage.
   void PrintStats() override;
 
+  /// \brief Retrieve the layout of the given record stored in the AST file
+  /// it was loaded from, if any.
+  const ASTRecordLayout *
+  getSerializedRecordLayout(const RecordDecl *Record) override;
+
   /// \brief Dump information about the AST reader to standard error.
   void dump();
 
@@ -16,6 +16,7 @@
 #ifndef LLVM_CLANG_SERIALIZATION_GLOBALMODULEINDEX_H
 #define LLVM_CLANG_SERIALIZATION_GLOBALMODULEINDEX_H
 
+#include "clang/Basic/Module.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
@@ -90,6 +91,10 @@ class GlobalModuleIndex {
     /// \brief The module IDs on which this module directly depends.
     /// FIXME: We don't really need a vector here.
     llvm::SmallVector<unsigned, 4> Dependencies;
+
+    /// \brief The signature of the module file at the time the global index
+    /// was built, if it has one.
+    ASTFileSignature Signature;
   };
 
   /// \brief A mapping from module IDs to information about each module.
@@ -191,7 +196,12 @@ public:
   /// \brief Print debugging view to standard error.
   void dump();
 
-  /// \brief Write a global index into the given
+  /// \brief Write a global index into the given directory.
+  ///
+  /// If an index already exists in that directory, the information it holds
+  /// about module files that have not changed since it was written (and
+  /// whose dependencies have not changed either) is reused, so that only new
+  /// or rebuilt module files need to be loaded.
   ///
   /// \param FileMgr The file manager to use to load module files.
   /// \param PCHContainerRdr - The PCHContainerOperations to use for loading and
@@ -423,6 +423,10 @@ public:
   /// module.
   SmallVector<uint64_t, 1> ObjCCategories;
 
+  /// \brief The layouts of the records declared in this module that were
+  /// computed while building it, as a sequence of length-prefixed entries.
+  SmallVector<uint64_t, 0> RecordLayouts;
+
   // === Types ===
 
   /// \brief The number of types in this AST file.
@@ -877,6 +877,33 @@ void ASTContext::PrintStats() const {
                << NumImplicitDestructors
                << " implicit destructors created\n";
 
+  // Name lookup tables.
+  unsigned NumLookupTables = 0, NumLookupEntries = 0, NumOverloadSets = 0;
+  size_t LookupBytes = 0;
+  for (StoredDeclsMap *Map = LastSDM.getPointer(); Map;
+       Map = Map->Previous.getPointer()) {
+    ++NumLookupTables;
+    NumLookupEntries += Map->size();
+    LookupBytes += sizeof(*Map) + Map->getMemorySize();
+    for (auto &Entry : *Map) {
+      if (StoredDeclsList::DeclsTy *Decls = Entry.second.getAsVector()) {
+        ++NumOverloadSets;
+        LookupBytes += sizeof(*Decls) + llvm::capacity_in_bytes(*Decls);
+      }
+    }
+  }
+  llvm::errs() << NumLookupTables << " name lookup tables, "
+               << NumLookupEntries << " names, " << NumOverloadSets
+               << " with multiple declarations\n";
+  llvm::errs() << "Total bytes in name lookup tables = " << LookupBytes
+               << "\n";
+
+  if (NumConstexprCallCacheHits || NumConstexprCallCacheMisses)
+    llvm::errs() << ConstexprCallResults.size()
+                 << " constexpr call results cached, "
+                 << NumConstexprCallCacheHits << " hits, "
+                 << NumConstexprCallCacheMisses << " misses\n";
+
   if (ExternalSource) {
     llvm::errs() << "\n";
     ExternalSource->PrintStats();
@@ -885,6 +912,23 @@ void ASTContext::PrintStats() const {
   BumpAlloc.PrintStats();
 }
 
+const llvm::APSInt *ASTContext::getConstexprCallResult(StringRef Key) const {
+  auto Known = ConstexprCallResults.find(Key);
+  if (Known == ConstexprCallResults.end()) {
+    ++NumConstexprCallCacheMisses;
+    return nullptr;
+  }
+  ++NumConstexprCallCacheHits;
+  return &Known->second;
+}
+
+void ASTContext::setConstexprCallResult(StringRef Key,
+                                        const llvm::APSInt &Result) {
+  if (ConstexprCallResults.size() >= getLangOpts().ConstexprCacheEntries)
+    return;
+  ConstexprCallResults.insert(std::make_pair(Key, Result));
+}
+
 void ASTContext::mergeDefinitionIntoModule(NamedDecl *ND, Module *M,
                                            bool NotifyListeners) {
   if (NotifyListeners)
@@ -0,0 +1,249 @@
+//===--- ASTMemoryStats.cpp - Memory accounting for the AST ---------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+//  This file implements ASTContext::PrintStatsJSON, which estimates the
+//  memory used by the AST from the sizes of its nodes, by node kind and by the
+//  file the nodes come from.
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/DeclCXX.h"
+#include "clang/AST/DeclFriend.h"
+#include "clang/AST/DeclObjC.h"
+#include "clang/AST/DeclOpenMP.h"
+#include "clang/AST/DeclTemplate.h"
+#include "clang/AST/ExprCXX.h"
+#include "clang/AST/ExprObjC.h"
+#include "clang/AST/ExprOpenMP.h"
+#include "clang/AST/RecursiveASTVisitor.h"
+#include "clang/AST/StmtCXX.h"
+#include "clang/AST/StmtObjC.h"
+#include "clang/AST/StmtOpenMP.h"
+#include "clang/Basic/SourceManager.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <vector>
+
+using namespace clang;
+
+namespace {
+/// The number and total size of the AST nodes of one kind, or from one file.
+struct NodeStats {
+  uint64_t Count = 0;
+  uint64_t Bytes = 0;
+
+  void add(uint64_t Size) {
+    ++Count;
+    Bytes += Size;
+  }
+};
+
+/// The declarations and statements attributed to a single file.
+struct FileStats {
+  NodeStats Decls;
+  NodeStats Stmts;
+};
+
+/// Walks the AST, attributing each declaration and statement to its kind and
+/// to the file containing (the expansion of) its location.
+class MemoryStatsCollector
+    : public RecursiveASTVisitor<MemoryStatsCollector> {
+  const SourceManager &SM;
+
+  llvm::DenseSet<const void *> Seen;
+
+  FileStats &getFileStats(SourceLocation Loc) {
+    StringRef Name = "<invalid>";
+    if (Loc.isValid()) {
+      FileID FID = SM.getFileID(SM.getExpansionLoc(Loc));
+      if (const FileEntry *FE = SM.getFileEntryForID(FID))
+        Name = FE->getName();
+      else
+        Name = SM.getBufferName(SM.getLocForStartOfFile(FID));
+    }
+    return Files[Name];
+  }
+
+public:
+  explicit MemoryStatsCollector(const SourceManager &SM) : SM(SM) {}
+
+  NodeStats DeclKinds[Decl::lastDecl + 1];
+  NodeStats StmtKinds[Stmt::lastStmtConstant + 1];
+  llvm::StringMap<FileStats> Files;
+
+  bool shouldVisitTemplateInstantiations() const { return true; }
+  bool shouldVisitImplicitCode() const { return true; }
+
+  bool TraverseDecl(Decl *D) {
+    // Declarations from an AST file are not counted: walking them would
+    // deserialize them, inflating the memory being measured.
+    if (D && D->isFromASTFile())
+      return true;
+    return RecursiveASTVisitor<MemoryStatsCollector>::TraverseDecl(D);
+  }
+
+  bool VisitDecl(Decl *D) {
+    if (!Seen.insert(D).second)
+      return true;
+
+    uint64_t Size = 0;
+    switch (D->getKind()) {
+#define DECL(DERIVED, BASE)                                                    \
+    case Decl::DERIVED:                                                        \
+      Size = sizeof(DERIVED##Decl);                                            \
+      break;
+#define ABSTRACT_DECL(DECL)
+#include "clang/AST/DeclNodes.inc"
+    }
+    DeclKinds[D->getKind()].add(Size);
+    getFileStats(D->getLocation()).Decls.add(Size);
+    return true;
+  }
+
+  bool VisitStmt(Stmt *S) {
+    if (!Seen.insert(S).second)
+      return true;
+
+    uint64_t Size = 0;
+    switch (S->getStmtClass()) {
+    case Stmt::NoStmtClass:
+      break;
+#define ABSTRACT_STMT(STMT)
+#define STMT(CLASS, PARENT)                                                    \
+    case Stmt::CLASS##Class:                                                   \
+      Size = sizeof(CLASS);                                                    \
+      break;
+#include "clang/AST/StmtNodes.inc"
+    }
+    StmtKinds[S->getStmtClass()].add(Size);
+    getFileStats(S->getLocStart()).Stmts.add(Size);
+    return true;
+  }
+};
+} // end anonymous namespace
+
+/// Write \p Str as a quoted JSON string. Control characters are escaped as
+/// JSON requires; other bytes, including UTF-8 sequences, are written as is.
+static void printJSONString(raw_ostream &OS, StringRef Str) {
+  OS << '"';
+  for (unsigned char C : Str) {
+    switch (C) {
+    case '"':  OS << "\\\""; break;
+    case '\\': OS << "\\\\"; break;
+    case '\b': OS << "\\b"; break;
+    case '\f': OS << "\\f"; break;
+    case '\n': OS << "\\n"; break;
+    case '\r': OS << "\\r"; break;
+    case '\t': OS << "\\t"; break;
+    default:
+      if (C < 0x20)
+        OS << "\\u00" << llvm::hexdigit(C >> 4, /*LowerCase=*/true)
+           << llvm::hexdigit(C & 0xF, /*LowerCase=*/true);
+      else
+        OS << C;
+      break;
+    }
+  }
+  OS << '"';
+}
+
+static void printNodeStats(raw_ostream &OS, StringRef Name,
+                           const NodeStats &Stats, bool &First) {
+  if (!Stats.Count)
+    return;
+  OS << (First ? "\n" : ",\n") << "    \"" << Name << "\": {\"count\": "
+     << Stats.Count << ", \"bytes\": " << Stats.Bytes << "}";
+  First = false;
+}
+
+void ASTContext::PrintStatsJSON(raw_ostream &OS) const {
+  // Only walk the declarations of this translation unit that are already
+  // loaded; the translation unit's lexical contents from a PCH or module are
+  // left alone.
+  MemoryStatsCollector Collector(SourceMgr);
+  Collector.VisitDecl(getTranslationUnitDecl());
+  for (Decl *D : getTranslationUnitDecl()->noload_decls())
+    Collector.TraverseDecl(D);
+
+  OS << "{\n";
+  OS << "  \"allocated_bytes\": " << getASTAllocatedMemory() << ",\n";
+  OS << "  \"side_table_bytes\": " << getSideTableAllocatedMemory() << ",\n";
+
+  // Types are uniqued, so they are only attributed to their kind.
+  NodeStats TypeKinds[Type::TypeLast + 1];
+  for (const Type *T : Types) {
+    uint64_t Size = 0;
+    switch (T->getTypeClass()) {
+#define TYPE(Class, Base)                                                      \
+    case Type::Class:                                                          \
+      Size = sizeof(Class##Type);                                              \
+      break;
+#define ABSTRACT_TYPE(Class, Base)
+#include "clang/AST/TypeNodes.def"
+    }
+    TypeKinds[T->getTypeClass()].add(Size);
+  }
+
+  bool First = true;
+  OS << "  \"types\": {";
+#define TYPE(Class, Base)                                                      \
+  printNodeStats(OS, #Class, TypeKinds[Type::Class], First);
+#define ABSTRACT_TYPE(Class, Base)
+#include "clang/AST/TypeNodes.def"
+  OS << "\n  },\n";
+
+  First = true;
+  OS << "  \"decls\": {";
+#define DECL(DERIVED, BASE)                                                    \
+  printNodeStats(OS, #DERIVED, Collector.DeclKinds[Decl::DERIVED], First);
+#define ABSTRACT_DECL(DECL)
+#include "clang/AST/DeclNodes.inc"
+  OS << "\n  },\n";
+
+  First = true;
+  OS << "  \"stmts\": {";
+#define ABSTRACT_STMT(STMT)
+#define STMT(CLASS, PARENT)                                                    \
+  printNodeStats(OS, #CLASS, Collector.StmtKinds[Stmt::CLASS##Class], First);
+#include "clang/AST/StmtNodes.inc"
+  OS << "\n  },\n";
+
+  // List the files that account for the most memory first.
+  std::vector<const llvm::StringMapEntry<FileStats> *> Files;
+  for (const auto &Entry : Collector.Files)
+    Files.push_back(&Entry);
+  std::sort(Files.begin(), Files.end(),
+            [](const llvm::StringMapEntry<FileStats> *LHS,
+               const llvm::StringMapEntry<FileStats> *RHS) {
+              uint64_t LHSBytes =
+                  LHS->second.Decls.Bytes + LHS->second.Stmts.Bytes;
+              uint64_t RHSBytes =
+                  RHS->second.Decls.Bytes + RHS->second.Stmts.Bytes;
+              if (LHSBytes != RHSBytes)
+                return LHSBytes > RHSBytes;
+              return LHS->getKey() < RHS->getKey();
+            });
+
+  OS << "  \"files\": [";
+  for (unsigned I = 0, N = Files.size(); I != N; ++I) {
+    const FileStats &Stats = Files[I]->second;
+    OS << (I ? ",\n" : "\n") << "    {\"name\": ";
+    printJSONString(OS, Files[I]->getKey());
+    OS << ", \"decls\": " << Stats.Decls.Count
+       << ", \"decl_bytes\": " << Stats.Decls.Bytes
+       << ", \"stmts\": " << Stats.Stmts.Count
+       << ", \"stmt_bytes\": " << Stats.Stmts.Bytes << "}";
+  }
+  OS << "\n  ]\n";
+  OS << "}\n";
+}
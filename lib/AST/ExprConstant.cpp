@@ -44,6 +44,7 @@
 #include "clang/AST/TypeLoc.h"
 #include "clang/Basic/Builtins.h"
 #include "clang/Basic/TargetInfo.h"
+#include "llvm/ADT/SmallString.h"
 #include "llvm/Support/raw_ostream.h"
 #include <cstring>
 #include <functional>
@@ -523,6 +524,22 @@ namespace {
     }
   };
 
+  /// The case labels of a switch statement, sorted by value, so that a switch
+  /// which is evaluated repeatedly (for instance, in the body of a loop) does
+  /// not need to re-evaluate and scan all of its case labels each time.
+  struct SwitchCaseTable {
+    struct CaseRange {
+      APSInt LHS, RHS;
+      const SwitchCase *Case;
+    };
+
+    /// The non-empty case ranges, sorted by their lower bound.
+    SmallVector<CaseRange, 8> Ranges;
+
+    /// The default label, if any.
+    const SwitchCase *Default = nullptr;
+  };
+
   /// EvalInfo - This is a private struct used by the evaluator to capture
   /// information about a subexpression as it is folded.  It retains information
   /// about the AST context, but also maintains information about the folded
@@ -577,6 +594,11 @@ namespace {
     /// initialization.
     uint64_t ArrayInitIndex = -1;
 
+    /// SwitchCaseTables - The case lookup tables built for the switch
+    /// statements evaluated so far.
+    llvm::DenseMap<const SwitchStmt *, std::unique_ptr<SwitchCaseTable>>
+        SwitchCaseTables;
+
     /// HasActiveDiagnostic - Was the previous diagnostic stored? If so, further
     /// notes attached to it will also be stored, otherwise they will not be.
     bool HasActiveDiagnostic;
@@ -588,6 +610,17 @@ namespace {
     /// \brief Whether or not we're currently speculatively evaluating.
     bool IsSpeculativelyEvaluating;
 
+    /// \brief Whether calls to functions that are not constexpr may be
+    /// evaluated. Set when folding the initializer of a variable with static
+    /// storage duration, which may be initialized statically whenever its
+    /// dynamic initialization would have no side effects.
+    bool AllowNonConstexprCalls;
+
+    /// \brief The number of diagnostics requested so far, whether or not they
+    /// were stored. Used to tell whether a function call was evaluated
+    /// cleanly, and so whether its result may be memoized.
+    unsigned NumDiagnosticsRequested;
+
     enum EvaluationMode {
       /// Evaluate as a constant expression. Stop if we find that the expression
       /// is not a constant expression.
@@ -661,6 +694,7 @@ namespace {
         EvaluatingDecl((const ValueDecl *)nullptr),
         EvaluatingDeclValue(nullptr), HasActiveDiagnostic(false),
         HasFoldFailureDiagnostic(false), IsSpeculativelyEvaluating(false),
+        AllowNonConstexprCalls(false), NumDiagnosticsRequested(0),
         EvalMode(Mode) {}
 
     void setEvaluatingDecl(APValue::LValueBase Base, APValue &Value) {
@@ -772,12 +806,14 @@ namespace {
     FFDiag(SourceLocation Loc,
           diag::kind DiagId = diag::note_invalid_subexpr_in_const_expr,
           unsigned ExtraNotes = 0) {
+      ++NumDiagnosticsRequested;
       return Diag(Loc, DiagId, ExtraNotes, false);
     }
     
     OptionalDiagnostic FFDiag(const Expr *E, diag::kind DiagId
                               = diag::note_invalid_subexpr_in_const_expr,
                             unsigned ExtraNotes = 0) {
+      ++NumDiagnosticsRequested;
       if (EvalStatus.Diag)
         return Diag(E->getExprLoc(), DiagId, ExtraNotes, /*IsCCEDiag*/false);
       HasActiveDiagnostic = false;
@@ -792,6 +828,7 @@ namespace {
     OptionalDiagnostic CCEDiag(SourceLocation Loc, diag::kind DiagId
                                  = diag::note_invalid_subexpr_in_const_expr,
                                unsigned ExtraNotes = 0) {
+      ++NumDiagnosticsRequested;
       // Don't override a previous diagnostic. Don't bother collecting
       // diagnostics if we're evaluating for overflow.
       if (!EvalStatus.Diag || !EvalStatus.Diag->empty()) {
@@ -3637,9 +3674,15 @@ enum EvalStmtResult {
 }
 
 static bool EvaluateVarDecl(EvalInfo &Info, const VarDecl *VD) {
-  // We don't need to evaluate the initializer for a static local.
-  if (!VD->hasLocalStorage())
-    return true;
+  // We don't need to evaluate the initializer for a static local. Such a
+  // local can only appear in a function that is not constexpr, and its
+  // initialization might have side effects that we cannot model.
+  if (!VD->hasLocalStorage()) {
+    if (!Info.AllowNonConstexprCalls)
+      return true;
+    Info.FFDiag(VD->getLocation());
+    return false;
+  }
 
   LValue Result;
   Result.set(VD, Info.CurrentCall->Index);
@@ -3724,6 +3767,46 @@ static EvalStmtResult EvaluateLoopBody(StmtResult &Result, EvalInfo &Info,
   llvm_unreachable("Invalid EvalStmtResult!");
 }
 
+/// Find the switch case of \p SS which is selected by the condition value
+/// \p Value, or null if there is none.
+static const SwitchCase *findSwitchCase(EvalInfo &Info, const SwitchStmt *SS,
+                                        const APSInt &Value) {
+  std::unique_ptr<SwitchCaseTable> &Table = Info.SwitchCaseTables[SS];
+  if (!Table) {
+    Table = llvm::make_unique<SwitchCaseTable>();
+    for (const SwitchCase *SC = SS->getSwitchCaseList(); SC;
+         SC = SC->getNextSwitchCase()) {
+      if (isa<DefaultStmt>(SC)) {
+        Table->Default = SC;
+        continue;
+      }
+
+      const CaseStmt *CS = cast<CaseStmt>(SC);
+      APSInt LHS = CS->getLHS()->EvaluateKnownConstInt(Info.Ctx);
+      APSInt RHS = CS->getRHS() ? CS->getRHS()->EvaluateKnownConstInt(Info.Ctx)
+                                : LHS;
+      // An empty GNU case range can never be selected.
+      if (RHS < LHS)
+        continue;
+      Table->Ranges.push_back({std::move(LHS), std::move(RHS), SC});
+    }
+    std::sort(Table->Ranges.begin(), Table->Ranges.end(),
+              [](const SwitchCaseTable::CaseRange &A,
+                 const SwitchCaseTable::CaseRange &B) { return A.LHS < B.LHS; });
+  }
+
+  // Find the last range starting at or before the value; the ranges of a
+  // valid switch statement do not overlap, so that's the only candidate.
+  auto It = std::upper_bound(Table->Ranges.begin(), Table->Ranges.end(), Value,
+                             [](const APSInt &V,
+                                const SwitchCaseTable::CaseRange &R) {
+                               return V < R.LHS;
+                             });
+  if (It != Table->Ranges.begin() && Value <= std::prev(It)->RHS)
+    return std::prev(It)->Case;
+  return Table->Default;
+}
+
 /// Evaluate a switch statement.
 static EvalStmtResult EvaluateSwitch(StmtResult &Result, EvalInfo &Info,
                                      const SwitchStmt *SS) {
@@ -3746,25 +3829,7 @@ static EvalStmtResult EvaluateSwitch(StmtResult &Result, EvalInfo &Info,
   }
 
   // Find the switch case corresponding to the value of the condition.
-  // FIXME: Cache this lookup.
-  const SwitchCase *Found = nullptr;
-  for (const SwitchCase *SC = SS->getSwitchCaseList(); SC;
-       SC = SC->getNextSwitchCase()) {
-    if (isa<DefaultStmt>(SC)) {
-      Found = SC;
-      continue;
-    }
-
-    const CaseStmt *CS = cast<CaseStmt>(SC);
-    APSInt LHS = CS->getLHS()->EvaluateKnownConstInt(Info.Ctx);
-    APSInt RHS = CS->getRHS() ? CS->getRHS()->EvaluateKnownConstInt(Info.Ctx)
-                              : LHS;
-    if (LHS <= Value && Value <= RHS) {
-      Found = SC;
-      break;
-    }
-  }
-
+  const SwitchCase *Found = findSwitchCase(Info, SS, Value);
   if (!Found)
     return ESR_Succeeded;
 
@@ -4099,6 +4164,20 @@ static bool CheckTrivialDefaultConstructor(EvalInfo &Info, SourceLocation Loc,
   return true;
 }
 
+/// Determine whether the definition of a function may be replaced by another
+/// one at link or load time, so that evaluating it need not give the value
+/// that the program computes when it runs.
+static bool isInterposable(const ASTContext &Ctx, const FunctionDecl *FD) {
+  if (FD->isWeak() || FD->isReplaceableGlobalAllocationFunction())
+    return true;
+  // In a shared library, calls to a visible function that is not covered by
+  // the ODR can be bound to a definition in another module.
+  const LangOptions &LangOpts = Ctx.getLangOpts();
+  return LangOpts.PICLevel && !LangOpts.PIE &&
+         Ctx.GetGVALinkageForFunction(FD) == GVA_StrongExternal &&
+         FD->getVisibility() == DefaultVisibility;
+}
+
 /// CheckConstexprFunction - Check that a function can be called in a constant
 /// expression.
 static bool CheckConstexprFunction(EvalInfo &Info, SourceLocation CallLoc,
@@ -4121,6 +4200,18 @@ static bool CheckConstexprFunction(EvalInfo &Info, SourceLocation CallLoc,
       !Definition->isInvalidDecl() && Body)
     return true;
 
+  // When folding a static initializer, other functions can be evaluated too,
+  // provided that no argument would need to be destroyed: the evaluator does
+  // not model the side effects of destructors. The definition must also be
+  // the one that the program will call.
+  if (Info.AllowNonConstexprCalls && Definition &&
+      !Definition->isInvalidDecl() && Body &&
+      !isInterposable(Info.Ctx, Definition) &&
+      llvm::all_of(Definition->parameters(), [&](const ParmVarDecl *PVD) {
+        return PVD->getType()->isLiteralType(Info.Ctx);
+      }))
+    return true;
+
   if (Info.getLangOpts().CPlusPlus11) {
     const FunctionDecl *DiagDecl = Definition ? Definition : Declaration;
     
@@ -4186,6 +4277,51 @@ static bool EvaluateArgs(ArrayRef<const Expr*> Args, ArgVector &ArgValues,
   return Success;
 }
 
+/// Build the key under which the result of a call to \p Callee with the given
+/// arguments is memoized in the ASTContext. Only calls to constexpr functions
+/// whose parameters and result are all integral values are memoized: such a
+/// call cannot observe or modify any state other than its arguments, so its
+/// result is fully determined by the callee and the argument values.
+///
+/// Calls are only memoized when evaluating a constant expression. The other
+/// modes may carry on past problems that a constant expression would reject:
+/// in particular, EM_EvaluateForOverflow reports overflow directly and then
+/// continues with the wrapped value.
+///
+/// \returns false if the call is not eligible for memoization.
+static bool buildConstexprCallKey(const FunctionDecl *Callee,
+                                  const LValue *This,
+                                  ArrayRef<APValue> ArgValues, EvalInfo &Info,
+                                  SmallVectorImpl<char> &Key) {
+  if (This || !Callee->isConstexpr() || Callee->isVariadic() ||
+      Info.EvalMode != EvalInfo::EM_ConstantExpression ||
+      Info.AllowNonConstexprCalls ||
+      !Info.getLangOpts().ConstexprCacheEntries ||
+      Info.EvalStatus.HasSideEffects || Info.EvalStatus.HasUndefinedBehavior)
+    return false;
+
+  if (!Callee->getReturnType()->isIntegralOrEnumerationType() ||
+      Callee->getNumParams() != ArgValues.size())
+    return false;
+  for (unsigned I = 0, N = ArgValues.size(); I != N; ++I) {
+    if (!Callee->getParamDecl(I)->getType()->isIntegralOrEnumerationType() ||
+        !ArgValues[I].isInt())
+      return false;
+  }
+
+  llvm::raw_svector_ostream OS(Key);
+  const void *CalleeKey = Callee->getCanonicalDecl();
+  OS.write(reinterpret_cast<const char *>(&CalleeKey), sizeof(CalleeKey));
+  for (const APValue &Arg : ArgValues) {
+    const APSInt &Value = Arg.getInt();
+    uint32_t Header = (Value.getBitWidth() << 1) | Value.isUnsigned();
+    OS.write(reinterpret_cast<const char *>(&Header), sizeof(Header));
+    OS.write(reinterpret_cast<const char *>(Value.getRawData()),
+             Value.getNumWords() * sizeof(uint64_t));
+  }
+  return true;
+}
+
 /// Evaluate a function call.
 static bool HandleFunctionCall(SourceLocation CallLoc,
                                const FunctionDecl *Callee, const LValue *This,
@@ -4196,6 +4332,16 @@ static bool HandleFunctionCall(SourceLocation CallLoc,
   if (!EvaluateArgs(Args, ArgValues, Info))
     return false;
 
+  // If we have already evaluated this call, reuse the result.
+  SmallString<64> CacheKey;
+  bool Memoize = buildConstexprCallKey(Callee, This, ArgValues, Info, CacheKey);
+  if (Memoize) {
+    if (const APSInt *Cached = Info.Ctx.getConstexprCallResult(CacheKey)) {
+      Result = APValue(*Cached);
+      return true;
+    }
+  }
+
   if (!Info.CheckCallLimit(CallLoc))
     return false;
 
@@ -4230,6 +4376,7 @@ static bool HandleFunctionCall(SourceLocation CallLoc,
                                       Frame.LambdaThisCaptureField);
   }
 
+  unsigned DiagsBefore = Info.NumDiagnosticsRequested;
   StmtResult Ret = {Result, ResultSlot};
   EvalStmtResult ESR = EvaluateStmt(Ret, Info, Body);
   if (ESR == ESR_Succeeded) {
@@ -4237,6 +4384,13 @@ static bool HandleFunctionCall(SourceLocation CallLoc,
       return true;
     Info.FFDiag(Callee->getLocEnd(), diag::note_constexpr_no_return);
   }
+
+  // Only remember calls that were evaluated without any diagnostic, side
+  // effect or undefined behavior; replaying the result would lose those.
+  if (Memoize && ESR == ESR_Returned && Result.isInt() &&
+      Info.NumDiagnosticsRequested == DiagsBefore &&
+      !Info.EvalStatus.HasSideEffects && !Info.EvalStatus.HasUndefinedBehavior)
+    Info.Ctx.setConstexprCallResult(CacheKey, Result.getInt());
   return ESR == ESR_Returned;
 }
 
@@ -10051,22 +10205,25 @@ bool Expr::EvaluateAsLValue(EvalResult &Result, const ASTContext &Ctx) const {
   return true;
 }
 
-bool Expr::EvaluateAsInitializer(APValue &Value, const ASTContext &Ctx,
-                                 const VarDecl *VD,
-                            SmallVectorImpl<PartialDiagnosticAt> &Notes) const {
+static bool EvaluateAsInitializer(const Expr *E, APValue &Value,
+                                  const ASTContext &Ctx, const VarDecl *VD,
+                                  SmallVectorImpl<PartialDiagnosticAt> *Notes,
+                                  bool AllowNonConstexprCalls) {
   // FIXME: Evaluating initializers for large array and record types can cause
   // performance problems. Only do so in C++11 for now.
-  if (isRValue() && (getType()->isArrayType() || getType()->isRecordType()) &&
+  if (E->isRValue() &&
+      (E->getType()->isArrayType() || E->getType()->isRecordType()) &&
       !Ctx.getLangOpts().CPlusPlus11)
     return false;
 
   Expr::EvalStatus EStatus;
-  EStatus.Diag = &Notes;
+  EStatus.Diag = Notes;
 
   EvalInfo InitInfo(Ctx, EStatus, VD->isConstexpr()
                                       ? EvalInfo::EM_ConstantExpression
                                       : EvalInfo::EM_ConstantFold);
   InitInfo.setEvaluatingDecl(VD, Value);
+  InitInfo.AllowNonConstexprCalls = AllowNonConstexprCalls;
 
   LValue LVal;
   LVal.set(VD);
@@ -10083,7 +10240,7 @@ bool Expr::EvaluateAsInitializer(APValue &Value, const ASTContext &Ctx,
       return false;
   }
 
-  if (!EvaluateInPlace(Value, InitInfo, LVal, this,
+  if (!EvaluateInPlace(Value, InitInfo, LVal, E,
                        /*AllowNonLiteralTypes=*/true) ||
       EStatus.HasSideEffects)
     return false;
@@ -10092,6 +10249,20 @@ bool Expr::EvaluateAsInitializer(APValue &Value, const ASTContext &Ctx,
                                  Value);
 }
 
+bool Expr::EvaluateAsInitializer(APValue &Value, const ASTContext &Ctx,
+                                 const VarDecl *VD,
+                            SmallVectorImpl<PartialDiagnosticAt> &Notes) const {
+  return ::EvaluateAsInitializer(this, Value, Ctx, VD, &Notes,
+                                 /*AllowNonConstexprCalls=*/false);
+}
+
+bool Expr::EvaluateAsStaticInitializer(APValue &Value, const ASTContext &Ctx,
+                                       const VarDecl *VD) const {
+  assert(!VD->hasLocalStorage() && "not a variable with static storage");
+  return ::EvaluateAsInitializer(this, Value, Ctx, VD, /*Notes=*/nullptr,
+                                 /*AllowNonConstexprCalls=*/true);
+}
+
 /// isEvaluatable - Call EvaluateAsRValue to see if this expression can be
 /// constant folded, but discard the result.
 bool Expr::isEvaluatable(const ASTContext &Ctx, SideEffectsKind SEK) const {
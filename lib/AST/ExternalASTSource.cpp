@@ -76,6 +76,11 @@ bool ExternalASTSource::layoutRecordType(
   return false;
 }
 
+const ASTRecordLayout *
+ExternalASTSource::getSerializedRecordLayout(const RecordDecl *Record) {
+  return nullptr;
+}
+
 Decl *ExternalASTSource::GetExternalDecl(uint32_t ID) {
   return nullptr;
 }
@@ -2942,7 +2942,15 @@ ASTContext::getASTRecordLayout(const RecordDecl *D) const {
 
   const ASTRecordLayout *NewEntry = nullptr;
 
-  if (isMsLayout(*this)) {
+  // Records loaded from an AST file may have been laid out while that file
+  // was built; reuse that layout rather than computing it again.
+  if (D->isFromASTFile())
+    if (ExternalASTSource *Source = getExternalSource())
+      NewEntry = Source->getSerializedRecordLayout(D);
+
+  if (NewEntry) {
+    // Nothing to compute.
+  } else if (isMsLayout(*this)) {
     MicrosoftRecordLayoutBuilder Builder(*this);
     if (const auto *RD = dyn_cast<CXXRecordDecl>(D)) {
       Builder.cxxLayout(RD);
@@ -17,6 +17,7 @@
 #include "clang/Lex/HeaderSearchOptions.h"
 #include "llvm/ADT/SmallSet.h"
 #include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringSwitch.h"
 #include "llvm/ADT/Triple.h"
 #include "llvm/Analysis/TargetLibraryInfo.h"
@@ -40,6 +41,7 @@
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/PrettyStackTrace.h"
 #include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/Timer.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Target/TargetMachine.h"
@@ -54,8 +56,11 @@
 #include "llvm/Transforms/ObjCARC.h"
 #include "llvm/Transforms/Scalar.h"
 #include "llvm/Transforms/Scalar/GVN.h"
+#include "llvm/Transforms/Utils/Cloning.h"
 #include "llvm/Transforms/Utils/NameAnonGlobals.h"
+#include "llvm/Transforms/Utils/SplitModule.h"
 #include "llvm/Transforms/Utils/SymbolRewriter.h"
+#include "llvm/Transforms/Vectorize.h"
 #include <memory>
 using namespace clang;
 using namespace llvm;
@@ -96,12 +101,27 @@ class EmitAssemblyHelper {
   /// the requested target.
   void CreateTargetMachine(bool MustCreateTM);
 
+  /// Creates a TargetMachine for \p TheTarget, configured from the options.
+  std::unique_ptr<TargetMachine>
+  newTargetMachine(const llvm::Target &TheTarget) const;
+
   /// Add passes necessary to emit assembly or LLVM IR.
   ///
   /// \return True on success.
   bool AddEmitPasses(legacy::PassManager &CodeGenPasses, BackendAction Action,
                      raw_pwrite_stream &OS);
 
+  /// Split the optimized module into partitions and generate code for them
+  /// concurrently. The output of the first partition is written to \p OS, and
+  /// that of the others to CodeGenOpts.ParallelCodeGenOutputs.
+  void RunParallelCodeGen(BackendAction Action, raw_pwrite_stream &OS);
+
+  /// Optimize the functions that __attribute__((optimize)) asks to optimize
+  /// at a higher level than the translation unit, or to unroll loops in when
+  /// the translation unit does not, before the module pipeline runs at the
+  /// level of the translation unit.
+  void RunFunctionLevelPasses();
+
 public:
   EmitAssemblyHelper(DiagnosticsEngine &_Diags,
                      const HeaderSearchOptions &HeaderSearchOpts,
@@ -657,6 +677,11 @@ void EmitAssemblyHelper::CreateTargetMachine(bool MustCreateTM) {
     return;
   }
 
+  TM = newTargetMachine(*TheTarget);
+}
+
+std::unique_ptr<TargetMachine>
+EmitAssemblyHelper::newTargetMachine(const llvm::Target &TheTarget) const {
   llvm::CodeModel::Model CM  = getCodeModel(CodeGenOpts);
   std::string FeaturesStr =
       llvm::join(TargetOpts.Features.begin(), TargetOpts.Features.end(), ",");
@@ -665,15 +690,20 @@ void EmitAssemblyHelper::CreateTargetMachine(bool MustCreateTM) {
 
   llvm::TargetOptions Options;
   initTargetOptions(Options, CodeGenOpts, TargetOpts, LangOpts, HSOpts);
-  TM.reset(TheTarget->createTargetMachine(Triple, TargetOpts.CPU, FeaturesStr,
-                                          Options, RM, CM, OptLevel));
+  return std::unique_ptr<TargetMachine>(TheTarget.createTargetMachine(
+      TheModule->getTargetTriple(), TargetOpts.CPU, FeaturesStr, Options, RM,
+      CM, OptLevel));
 }
 
-bool EmitAssemblyHelper::AddEmitPasses(legacy::PassManager &CodeGenPasses,
-                                       BackendAction Action,
-                                       raw_pwrite_stream &OS) {
+/// Add the passes that generate code for a module to \p CodeGenPasses.
+///
+/// \return True on success.
+static bool addCodeGenPasses(legacy::PassManager &CodeGenPasses,
+                             TargetMachine &TM,
+                             const CodeGenOptions &CodeGenOpts,
+                             BackendAction Action, raw_pwrite_stream &OS) {
   // Add LibraryInfo.
-  llvm::Triple TargetTriple(TheModule->getTargetTriple());
+  llvm::Triple TargetTriple(TM.getTargetTriple());
   std::unique_ptr<TargetLibraryInfoImpl> TLII(
       createTLII(TargetTriple, CodeGenOpts));
   CodeGenPasses.add(new TargetLibraryInfoWrapperPass(*TLII));
@@ -688,8 +718,14 @@ bool EmitAssemblyHelper::AddEmitPasses(legacy::PassManager &CodeGenPasses,
   if (CodeGenOpts.OptimizationLevel > 0)
     CodeGenPasses.add(createObjCARCContractPass());
 
-  if (TM->addPassesToEmitFile(CodeGenPasses, OS, CGFT,
-                              /*DisableVerify=*/!CodeGenOpts.VerifyModule)) {
+  return !TM.addPassesToEmitFile(CodeGenPasses, OS, CGFT,
+                                 /*DisableVerify=*/!CodeGenOpts.VerifyModule);
+}
+
+bool EmitAssemblyHelper::AddEmitPasses(legacy::PassManager &CodeGenPasses,
+                                       BackendAction Action,
+                                       raw_pwrite_stream &OS) {
+  if (!addCodeGenPasses(CodeGenPasses, *TM, CodeGenOpts, Action, OS)) {
     Diags.Report(diag::err_fe_unable_to_interface_with_target);
     return false;
   }
@@ -697,6 +733,218 @@ bool EmitAssemblyHelper::AddEmitPasses(legacy::PassManager &CodeGenPasses,
   return true;
 }
 
+void EmitAssemblyHelper::RunParallelCodeGen(BackendAction Action,
+                                            raw_pwrite_stream &OS) {
+  SmallVector<raw_pwrite_stream *, 8> OSs;
+  SmallVector<std::unique_ptr<raw_fd_ostream>, 8> PartitionFiles;
+  OSs.push_back(&OS);
+  for (const std::string &Path : CodeGenOpts.ParallelCodeGenOutputs) {
+    std::error_code EC;
+    PartitionFiles.push_back(
+        llvm::make_unique<raw_fd_ostream>(Path, EC, llvm::sys::fs::F_None));
+    if (EC) {
+      Diags.Report(diag::err_fe_unable_to_open_output) << Path << EC.message();
+      return;
+    }
+    OSs.push_back(PartitionFiles.back().get());
+  }
+
+  // Set up everything that may need to report an error here, so that the
+  // worker threads only run the code generator.
+  SmallVector<std::unique_ptr<TargetMachine>, 8> TMs;
+  SmallVector<std::unique_ptr<legacy::PassManager>, 8> CodeGenPasses;
+  for (raw_pwrite_stream *PartitionOS : OSs) {
+    TMs.push_back(newTargetMachine(TM->getTarget()));
+    CodeGenPasses.push_back(llvm::make_unique<legacy::PassManager>());
+    CodeGenPasses.back()->add(createTargetTransformInfoWrapperPass(
+        TMs.back()->getTargetIRAnalysis()));
+    if (!addCodeGenPasses(*CodeGenPasses.back(), *TMs.back(), CodeGenOpts,
+                          Action, *PartitionOS)) {
+      Diags.Report(diag::err_fe_unable_to_interface_with_target);
+      return;
+    }
+  }
+
+  // Each partition is handed to its thread as bitcode, so that it can be
+  // loaded into an LLVMContext of its own. Local symbols are kept in the
+  // same partition as all of their users, so they stay local: the
+  // partitions are combined by a relocatable link, which would otherwise
+  // clash on the local symbols of different translation units. SplitModule
+  // takes ownership of the module it splits, and TheModule still belongs to
+  // the caller, so it is given a copy.
+  SmallVector<SmallString<0>, 8> Partitions;
+  Partitions.reserve(OSs.size());
+  SplitModule(CloneModule(TheModule), OSs.size(),
+              [&](std::unique_ptr<Module> MPart) {
+                Partitions.emplace_back();
+                raw_svector_ostream BCOS(Partitions.back());
+                WriteBitcodeToFile(MPart.get(), BCOS);
+              },
+              /*PreserveLocals=*/true);
+
+  ThreadPool CodeGenThreadPool(Partitions.size());
+  for (unsigned I = 0, N = Partitions.size(); I != N; ++I)
+    CodeGenThreadPool.async([&, I]() {
+      LLVMContext Ctx;
+      Expected<std::unique_ptr<Module>> MPart = parseBitcodeFile(
+          MemoryBufferRef(Partitions[I], "<partition>"), Ctx);
+      if (!MPart)
+        report_fatal_error("Failed to read code generation partition: " +
+                           toString(MPart.takeError()));
+      CodeGenPasses[I]->run(**MPart);
+    });
+  CodeGenThreadPool.wait();
+}
+
+static unsigned countInstructions(const Function &F) {
+  unsigned NumInsts = 0;
+  for (const BasicBlock &BB : F)
+    NumInsts += BB.size();
+  return NumInsts;
+}
+
+/// Merge structurally identical function definitions, such as template
+/// specializations whose bodies do not depend on the template arguments,
+/// before the optimizer runs, so that it only processes one copy of each.
+static void mergeIdenticalFunctions(Module &M, DiagnosticsEngine &Diags) {
+  PrettyStackTraceString CrashInfo("Merging identical functions");
+
+  // Merged functions are either erased or replaced by a new thunk of the same
+  // name, so track them by name.
+  StringMap<unsigned> SizeBefore;
+  unsigned NumInstsBefore = 0;
+  for (const Function &F : M) {
+    if (F.isDeclaration() || !F.hasName())
+      continue;
+    unsigned NumInsts = countInstructions(F);
+    SizeBefore[F.getName()] = NumInsts;
+    NumInstsBefore += NumInsts;
+  }
+
+  legacy::PassManager MergePasses;
+  MergePasses.add(createMergeFunctionsPass());
+  MergePasses.run(M);
+
+  unsigned NumInstsAfter = 0, NumMerged = 0;
+  for (const StringMapEntry<unsigned> &Entry : SizeBefore) {
+    const Function *F = M.getFunction(Entry.getKey());
+    unsigned NumInsts =
+        F && !F->isDeclaration() ? countInstructions(*F) : 0;
+    NumInstsAfter += NumInsts;
+    if (NumInsts < Entry.getValue())
+      ++NumMerged;
+  }
+
+  Diags.Report(diag::remark_fe_merged_identical_functions)
+      << (NumInstsBefore - std::min(NumInstsBefore, NumInstsAfter))
+      << NumInstsBefore << NumMerged << unsigned(SizeBefore.size());
+}
+
+/// Add the function simplification and loop optimization passes of the -O<N>
+/// pipeline to \p FPM, for use on functions that request level \p OptLevel.
+/// Loops are unrolled if \p UnrollLoops is set; \p ForceUnrollLoops also
+/// enables partial and runtime unrolling, within the unroller's usual cost
+/// thresholds, as -funroll-loops does in GCC.
+static void addFunctionOptimizationPasses(legacy::FunctionPassManager &FPM,
+                                          unsigned OptLevel, bool UnrollLoops,
+                                          bool ForceUnrollLoops) {
+  FPM.add(createSROAPass());
+  FPM.add(createEarlyCSEPass());
+  FPM.add(createCFGSimplificationPass());
+  FPM.add(createInstructionCombiningPass());
+  if (OptLevel > 1)
+    FPM.add(createJumpThreadingPass());
+  FPM.add(createCorrelatedValuePropagationPass());
+  FPM.add(createReassociatePass());
+  FPM.add(createLoopRotatePass());
+  FPM.add(createLICMPass());
+  FPM.add(createCFGSimplificationPass());
+  FPM.add(createInstructionCombiningPass());
+  FPM.add(createIndVarSimplifyPass());
+  FPM.add(createLoopIdiomPass());
+  FPM.add(createLoopDeletionPass());
+  if (UnrollLoops)
+    FPM.add(createSimpleLoopUnrollPass(OptLevel));
+  if (OptLevel > 1)
+    FPM.add(createGVNPass());
+  FPM.add(createMemCpyOptPass());
+  FPM.add(createSCCPPass());
+  FPM.add(createInstructionCombiningPass());
+  FPM.add(createDeadStoreEliminationPass());
+  FPM.add(createLICMPass());
+  FPM.add(createAggressiveDCEPass());
+  FPM.add(createCFGSimplificationPass());
+  FPM.add(createInstructionCombiningPass());
+  if (OptLevel > 1) {
+    FPM.add(createLoopVectorizePass());
+    FPM.add(createInstructionCombiningPass());
+  }
+  if (OptLevel > 2)
+    FPM.add(createSLPVectorizerPass());
+  FPM.add(createCFGSimplificationPass());
+  FPM.add(createInstructionCombiningPass());
+  if (UnrollLoops) {
+    int Unroll = ForceUnrollLoops ? 1 : -1;
+    FPM.add(createLoopUnrollPass(OptLevel, /*Threshold=*/-1, /*Count=*/-1,
+                                 /*AllowPartial=*/Unroll, /*Runtime=*/Unroll));
+    FPM.add(createInstructionCombiningPass());
+  }
+}
+
+void EmitAssemblyHelper::RunFunctionLevelPasses() {
+  if (CodeGenOpts.DisableLLVMPasses)
+    return;
+
+  // Group the functions that need a function pipeline of their own by its
+  // level and by whether they asked for loop unrolling: either their level is
+  // above that of the translation unit, or they use "unroll-loops" while the
+  // translation unit does not unroll loops.
+  SmallVector<Function *, 8> Groups[4][2];
+  bool AnyGroup = false;
+  for (Function &F : *TheModule) {
+    if (F.isDeclaration() || F.hasFnAttribute(Attribute::OptimizeNone))
+      continue;
+    unsigned Level = CodeGenOpts.OptimizationLevel;
+    if (F.hasFnAttribute("opt-level") &&
+        F.getFnAttribute("opt-level").getValueAsString().getAsInteger(10,
+                                                                      Level))
+      continue;
+    bool ForceUnroll = F.hasFnAttribute("unroll-loops");
+    if (Level == 0 || Level > 3 ||
+        (Level <= CodeGenOpts.OptimizationLevel &&
+         (!ForceUnroll || CodeGenOpts.UnrollLoops)))
+      continue;
+    Groups[Level][ForceUnroll].push_back(&F);
+    AnyGroup = true;
+  }
+  if (!AnyGroup)
+    return;
+
+  Triple TargetTriple(TheModule->getTargetTriple());
+  std::unique_ptr<TargetLibraryInfoImpl> TLII(
+      createTLII(TargetTriple, CodeGenOpts));
+
+  PrettyStackTraceString CrashInfo("Function-level optimization");
+  for (unsigned Level = 1; Level <= 3; ++Level) {
+    for (bool ForceUnroll : {false, true}) {
+      if (Groups[Level][ForceUnroll].empty())
+        continue;
+
+      legacy::FunctionPassManager FPM(TheModule);
+      FPM.add(createTargetTransformInfoWrapperPass(getTargetIRAnalysis()));
+      FPM.add(new TargetLibraryInfoWrapperPass(*TLII));
+      addFunctionOptimizationPasses(FPM, Level,
+                                    CodeGenOpts.UnrollLoops || ForceUnroll,
+                                    ForceUnroll);
+
+      FPM.doInitialization();
+      for (Function *F : Groups[Level][ForceUnroll])
+        FPM.run(*F);
+      FPM.doFinalization();
+    }
+  }
+}
+
 void EmitAssemblyHelper::EmitAssembly(BackendAction Action,
                                       std::unique_ptr<raw_pwrite_stream> OS) {
   TimeRegion Region(llvm::TimePassesIsEnabled ? &CodeGenerationTime : nullptr);
@@ -760,7 +1008,8 @@ void EmitAssemblyHelper::EmitAssembly(BackendAction Action,
     break;
 
   default:
-    if (!AddEmitPasses(CodeGenPasses, Action, *OS))
+    if (CodeGenOpts.ParallelCodeGenOutputs.empty() &&
+        !AddEmitPasses(CodeGenPasses, Action, *OS))
       return;
   }
 
@@ -770,6 +1019,11 @@ void EmitAssemblyHelper::EmitAssembly(BackendAction Action,
   // Run passes. For now we do all passes at once, but eventually we
   // would like to have the option of streaming code generation.
 
+  if (CodeGenOpts.MergeIdenticalFunctions && !CodeGenOpts.DisableLLVMPasses)
+    mergeIdenticalFunctions(*TheModule, Diags);
+
+  RunFunctionLevelPasses();
+
   {
     PrettyStackTraceString CrashInfo("Per-function optimization");
 
@@ -787,7 +1041,10 @@ void EmitAssemblyHelper::EmitAssembly(BackendAction Action,
 
   {
     PrettyStackTraceString CrashInfo("Code generation");
-    CodeGenPasses.run(*TheModule);
+    if (UsesCodeGen && !CodeGenOpts.ParallelCodeGenOutputs.empty())
+      RunParallelCodeGen(Action, *OS);
+    else
+      CodeGenPasses.run(*TheModule);
   }
 }
 
@@ -949,6 +1206,8 @@ void EmitAssemblyHelper::EmitAssemblyWithNewPassManager(
   case Backend_EmitMCNull:
   case Backend_EmitObj:
     NeedCodeGen = true;
+    if (!CodeGenOpts.ParallelCodeGenOutputs.empty())
+      break;
     CodeGenPasses.add(
         createTargetTransformInfoWrapperPass(getTargetIRAnalysis()));
     if (!AddEmitPasses(CodeGenPasses, Action, *OS))
@@ -960,6 +1219,11 @@ void EmitAssemblyHelper::EmitAssemblyWithNewPassManager(
   // Before executing passes, print the final values of the LLVM options.
   cl::PrintOptionValues();
 
+  if (CodeGenOpts.MergeIdenticalFunctions && !CodeGenOpts.DisableLLVMPasses)
+    mergeIdenticalFunctions(*TheModule, Diags);
+
+  RunFunctionLevelPasses();
+
   // Now that we have all of the passes ready, run them.
   {
     PrettyStackTraceString CrashInfo("Optimizer");
@@ -969,7 +1233,10 @@ void EmitAssemblyHelper::EmitAssemblyWithNewPassManager(
   // Now if needed, run the legacy PM for codegen.
   if (NeedCodeGen) {
     PrettyStackTraceString CrashInfo("Code generation");
-    CodeGenPasses.run(*TheModule);
+    if (!CodeGenOpts.ParallelCodeGenOutputs.empty())
+      RunParallelCodeGen(Action, *OS);
+    else
+      CodeGenPasses.run(*TheModule);
   }
 }
 
@@ -62,6 +62,7 @@ static uint32_t getDeclAlignIfRequired(const Decl *D, const ASTContext &Ctx) {
 CGDebugInfo::CGDebugInfo(CodeGenModule &CGM)
     : CGM(CGM), DebugKind(CGM.getCodeGenOpts().getDebugInfo()),
       DebugTypeExtRefs(CGM.getCodeGenOpts().DebugTypeExtRefs),
+      DebugCtorHoming(CGM.getCodeGenOpts().DebugCtorHoming),
       DBuilder(CGM.getModule()) {
   for (const auto &KV : CGM.getCodeGenOpts().DebugPrefixMap)
     DebugPrefixMap[KV.first] = KV.second;
@@ -1822,8 +1823,31 @@ static bool isDefinedInClangModule(const RecordDecl *RD) {
   return true;
 }
 
+/// Can the definition of \p RD be emitted only along with its constructors?
+/// That is the case when no object of the class can be created without
+/// calling one of its non-trivial, non-constexpr constructors.
+static bool canUseCtorHoming(const CXXRecordDecl *RD) {
+  // Microsoft debuggers don't resolve type information across DLL boundaries.
+  if (isClassOrMethodDLLImport(RD))
+    return false;
+
+  // Lambdas and aggregates can be created without calling a constructor.
+  if (RD->isLambda() || RD->isAggregate() ||
+      RD->hasTrivialDefaultConstructor() ||
+      RD->hasConstexprNonCopyMoveConstructor())
+    return false;
+
+  // A class without a usable constructor other than its copy and move
+  // constructors is never constructed normally; it is usually viewed through
+  // a cast over existing memory.
+  return llvm::any_of(RD->ctors(), [](const CXXConstructorDecl *Ctor) {
+    return !Ctor->isDeleted() && !Ctor->isCopyOrMoveConstructor();
+  });
+}
+
 static bool shouldOmitDefinition(codegenoptions::DebugInfoKind DebugKind,
-                                 bool DebugTypeExtRefs, const RecordDecl *RD,
+                                 bool DebugTypeExtRefs, bool DebugCtorHoming,
+                                 const RecordDecl *RD,
                                  const LangOptions &LangOpts) {
   if (DebugTypeExtRefs && isDefinedInClangModule(RD->getDefinition()))
     return true;
@@ -1865,11 +1889,18 @@ static bool shouldOmitDefinition(codegenoptions::DebugInfoKind DebugKind,
                                   CXXDecl->method_end()))
     return true;
 
+  // In constructor homing mode, only emit complete debug info for a class
+  // when one of its constructors is emitted.
+  if (DebugCtorHoming && CXXDecl->hasDefinition() &&
+      canUseCtorHoming(CXXDecl))
+    return true;
+
   return false;
 }
 
 void CGDebugInfo::completeRequiredType(const RecordDecl *RD) {
-  if (shouldOmitDefinition(DebugKind, DebugTypeExtRefs, RD, CGM.getLangOpts()))
+  if (shouldOmitDefinition(DebugKind, DebugTypeExtRefs, DebugCtorHoming, RD,
+                           CGM.getLangOpts()))
     return;
 
   QualType Ty = CGM.getContext().getRecordType(RD);
@@ -1881,8 +1912,8 @@ void CGDebugInfo::completeRequiredType(const RecordDecl *RD) {
 llvm::DIType *CGDebugInfo::CreateType(const RecordType *Ty) {
   RecordDecl *RD = Ty->getDecl();
   llvm::DIType *T = cast_or_null<llvm::DIType>(getTypeOrNull(QualType(Ty, 0)));
-  if (T || shouldOmitDefinition(DebugKind, DebugTypeExtRefs, RD,
-                                CGM.getLangOpts())) {
+  if (T || shouldOmitDefinition(DebugKind, DebugTypeExtRefs, DebugCtorHoming,
+                                RD, CGM.getLangOpts())) {
     if (!T)
       T = getOrCreateRecordFwdDecl(Ty, getDeclContextDescriptor(RD));
     return T;
@@ -3148,6 +3179,12 @@ void CGDebugInfo::EmitFunctionStart(GlobalDecl GD, SourceLocation Loc,
   const Decl *D = GD.getDecl();
   bool HasDecl = (D != nullptr);
 
+  // In constructor homing mode, the definition of a class is emitted along
+  // with its constructors.
+  if (DebugCtorHoming && DebugKind == codegenoptions::LimitedDebugInfo)
+    if (const auto *CD = dyn_cast_or_null<CXXConstructorDecl>(D))
+      completeUnusedClass(*CD->getParent());
+
   llvm::DINode::DIFlags Flags = llvm::DINode::FlagZero;
   llvm::DIFile *Unit = getOrCreateFile(Loc);
   llvm::DIScope *FDContext = Unit;
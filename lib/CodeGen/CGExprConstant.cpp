@@ -1221,6 +1221,18 @@ llvm::Constant *CodeGenModule::EmitConstantInit(const VarDecl &D,
   if (const APValue *Value = D.evaluateValue())
     return EmitConstantValueForMemory(*Value, D.getType(), CGF);
 
+  // C++ [basic.start.static]p3: a variable with static or thread storage
+  // duration may be initialized statically even if its initializer is not a
+  // constant expression, provided that the dynamic initialization would not
+  // have side effects. Try folding calls to non-constexpr functions too.
+  if (CodeGenOpts.FoldDynamicInitializers && getLangOpts().CPlusPlus11 &&
+      !D.hasLocalStorage() && D.getInit() &&
+      !D.getType()->isReferenceType()) {
+    APValue Value;
+    if (D.getInit()->EvaluateAsStaticInitializer(Value, Context, &D))
+      return EmitConstantValueForMemory(Value, D.getType(), CGF);
+  }
+
   // FIXME: Implement C++11 [basic.start.init]p2: if the initializer of a
   // reference is a constant expression, and the reference binds to a temporary,
   // then constant initialization is performed. ConstExprEmitter will
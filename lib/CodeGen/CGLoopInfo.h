@@ -60,6 +60,21 @@ struct LoopAttributes {
 
   /// \brief Value for llvm.loop.distribute.enable metadata.
   LVEnableState DistributeEnable;
+
+  /// \brief Value for llvm.loop.unroll_and_jam.* metadata (enable or disable).
+  LVEnableState UnrollAndJamEnable;
+
+  /// \brief Value for llvm.loop.unroll_and_jam.count metadata.
+  unsigned UnrollAndJamCount;
+
+  /// \brief Value for llvm.loop.vectorize.predicate.enable metadata.
+  LVEnableState VectorizePredicateEnable;
+
+  /// \brief Value for llvm.loop.pipeline.disable metadata.
+  bool PipelineDisabled;
+
+  /// \brief Value for llvm.loop.pipeline.initiationinterval metadata.
+  unsigned PipelineInitiationInterval;
 };
 
 /// \brief Information used when generating a structured loop.
@@ -95,7 +110,7 @@ class LoopInfoStack {
   void operator=(const LoopInfoStack &) = delete;
 
 public:
-  LoopInfoStack() {}
+  LoopInfoStack() : DefaultUnrollState(LoopAttributes::Unspecified) {}
 
   /// \brief Begin a new structured loop. The set of staged attributes will be
   /// applied to the loop and then cleared.
@@ -152,6 +167,33 @@ public:
   /// \brief Set the unroll count for the next loop pushed.
   void setUnrollCount(unsigned C) { StagedAttrs.UnrollCount = C; }
 
+  /// \brief Set the unroll state of the loops pushed without an unroll or
+  /// unroll count hint.
+  void setDefaultUnrollState(const LoopAttributes::LVEnableState &State) {
+    DefaultUnrollState = State;
+  }
+
+  /// \brief Set the next pushed loop unroll_and_jam state.
+  void setUnrollAndJamState(const LoopAttributes::LVEnableState &State) {
+    StagedAttrs.UnrollAndJamEnable = State;
+  }
+
+  /// \brief Set the unroll_and_jam count for the next loop pushed.
+  void setUnrollAndJamCount(unsigned C) { StagedAttrs.UnrollAndJamCount = C; }
+
+  /// \brief Set the next pushed loop 'vectorize.predicate.enable'.
+  void setVectorizePredicateState(const LoopAttributes::LVEnableState &State) {
+    StagedAttrs.VectorizePredicateEnable = State;
+  }
+
+  /// \brief Set the pipeline disabled state for the next loop pushed.
+  void setPipelineDisabled(bool S) { StagedAttrs.PipelineDisabled = S; }
+
+  /// \brief Set the pipeline initiation interval for the next loop pushed.
+  void setPipelineInitiationInterval(unsigned C) {
+    StagedAttrs.PipelineInitiationInterval = C;
+  }
+
 private:
   /// \brief Returns true if there is LoopInfo on the stack.
   bool hasInfo() const { return !Active.empty(); }
@@ -160,6 +202,8 @@ private:
   const LoopInfo &getInfo() const { return Active.back(); }
   /// \brief The set of attributes that will be applied to the next pushed loop.
   LoopAttributes StagedAttrs;
+  /// \brief Unroll state of loops that do not specify one.
+  LoopAttributes::LVEnableState DefaultUnrollState;
   /// \brief Stack of active loops.
   llvm::SmallVector<LoopInfo, 4> Active;
 };
@@ -751,6 +751,14 @@ void CodeGenFunction::StartFunction(GlobalDecl GD,
     // Apply the no_sanitize* attributes to SanOpts.
     for (auto Attr : D->specific_attrs<NoSanitizeAttr>())
       SanOpts.Mask &= ~Attr->getMask();
+
+    // Apply __attribute__((optimize("no-unroll-loops"))) to the loops that do
+    // not carry an unroll hint of their own. "unroll-loops" is handled by the
+    // backend instead, since llvm.loop.unroll.enable would unroll each loop as
+    // if by '#pragma unroll', well past the usual cost thresholds.
+    if (const auto *OA = D->getAttr<OptimizeAttr>())
+      if (OA->getUnrollLoops() == 0)
+        LoopStack.setDefaultUnrollState(LoopAttributes::Disable);
   }
 
   // Apply sanitizer attributes to the function.
@@ -951,6 +951,12 @@ void CodeGenModule::SetLLVMFunctionAttributesForDefinition(const Decl *D,
   ShouldAddOptNone &= !F->hasFnAttribute(llvm::Attribute::AlwaysInline);
   ShouldAddOptNone &= !D->hasAttr<AlwaysInlineAttr>();
 
+  // __attribute__((optimize)) overrides the optimization level of the
+  // translation unit for this function.
+  const auto *OA = D->getAttr<OptimizeAttr>();
+  char OptLevel = OA ? OA->getOptLevel() : '\0';
+  ShouldAddOptNone &= !OptLevel || OptLevel == '0';
+
   if (ShouldAddOptNone || D->hasAttr<OptimizeNoneAttr>()) {
     B.addAttribute(llvm::Attribute::OptimizeNone);
 
@@ -1012,6 +1018,21 @@ void CodeGenModule::SetLLVMFunctionAttributesForDefinition(const Decl *D,
 
     if (D->hasAttr<MinSizeAttr>())
       B.addAttribute(llvm::Attribute::MinSize);
+
+    // The backend runs a function pipeline at the requested level over
+    // functions asking for more optimization than the translation unit. -Os
+    // and -Oz are -O2 with size-conscious heuristics.
+    if (OptLevel == 's' || OptLevel == 'z') {
+      B.addAttribute(llvm::Attribute::OptimizeForSize);
+      B.addAttribute("opt-level", "2");
+    } else if (OptLevel >= '1' && OptLevel <= '3') {
+      B.addAttribute("opt-level", StringRef(&OptLevel, 1));
+    }
+
+    // The backend enables the loop unroller's heuristics for functions that
+    // ask to unroll loops.
+    if (OA && OA->getUnrollLoops() == 1)
+      B.addAttribute("unroll-loops");
   }
 
   F->addAttributes(llvm::AttributeList::FunctionIndex, B);
@@ -1383,6 +1404,14 @@ void CodeGenModule::EmitDeferred() {
   // Emit code for any potentially referenced deferred decls.  Since a
   // previously unused static decl may become used during the generation of code
   // for a static function, iterate until no changes are made.
+  //
+  // Note that this cannot be split across threads: emitting a body lazily
+  // computes and caches state in the ASTContext (record layouts, mangling
+  // numbers, vtable layouts), in CodeGenTypes, and in the LLVMContext (types
+  // and constants), and it can schedule further deferred decls and vtables.
+  // None of these are thread-safe, and emitting into separate modules would
+  // need a separate LLVMContext, and so a separate CodeGenModule, per thread.
+  // Use -fparallel-codegen to parallelize the backend instead.
 
   if (!DeferredVTables.empty()) {
     EmitDeferredVTables();
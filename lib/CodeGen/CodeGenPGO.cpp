@@ -18,6 +18,7 @@
 #include "clang/AST/StmtVisitor.h"
 #include "llvm/IR/Intrinsics.h"
 #include "llvm/IR/MDBuilder.h"
+#include "llvm/IR/ProfileSummary.h"
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MD5.h"
@@ -648,7 +649,7 @@ void CodeGenPGO::assignRegionCounters(GlobalDecl GD, llvm::Function *Fn) {
     SourceManager &SM = CGM.getContext().getSourceManager();
     loadRegionCounts(PGOReader, SM.isInMainFile(D->getLocation()));
     computeRegionCounts(D);
-    applyFunctionAttributes(PGOReader, Fn);
+    applyFunctionAttributes(PGOReader, D, Fn);
   }
 }
 
@@ -732,14 +733,44 @@ void CodeGenPGO::computeRegionCounts(const Decl *D) {
     Walker.VisitCapturedDecl(const_cast<CapturedDecl *>(CD));
 }
 
+/// Returns the smallest count among the hottest counters that together make up
+/// \p Cutoff millionths of the total count in the profile, or 0 if the profile
+/// summary does not say.
+static uint64_t getCountThreshold(llvm::ProfileSummary &Summary,
+                                  uint32_t Cutoff) {
+  for (const llvm::ProfileSummaryEntry &Entry : Summary.getDetailedSummary())
+    if (Entry.Cutoff >= Cutoff)
+      return Entry.MinCount;
+  return 0;
+}
+
 void
 CodeGenPGO::applyFunctionAttributes(llvm::IndexedInstrProfReader *PGOReader,
-                                    llvm::Function *Fn) {
+                                    const Decl *D, llvm::Function *Fn) {
   if (!haveRegionCounts())
     return;
 
   uint64_t FunctionCount = getRegionCount(nullptr);
   Fn->setEntryCount(FunctionCount);
+
+  // Group hot and cold functions together, to reduce i-cache and iTLB misses.
+  // Use the same cutoffs as LLVM's ProfileSummaryInfo: a count is hot if it
+  // is among the counts that make up 99% of the total, and cold if it is
+  // among those that make up the last 0.0001%.
+  llvm::ProfileSummary &Summary = PGOReader->getSummary();
+  uint64_t HotThreshold = getCountThreshold(Summary, 990000);
+  uint64_t ColdThreshold = getCountThreshold(Summary, 999999);
+  if (!HotThreshold || D->hasAttr<SectionAttr>())
+    return;
+
+  uint64_t MaxCount =
+      *std::max_element(RegionCounts.begin(), RegionCounts.end());
+  if (MaxCount >= HotThreshold) {
+    Fn->setSectionPrefix(".hot");
+  } else if (MaxCount <= ColdThreshold && !D->hasAttr<HotAttr>()) {
+    Fn->addFnAttr(llvm::Attribute::Cold);
+    Fn->setSectionPrefix(".unlikely");
+  }
 }
 
 void CodeGenPGO::emitCounterIncrement(CGBuilderTy &Builder, const Stmt *S,
@@ -770,7 +801,9 @@ void CodeGenPGO::emitCounterIncrement(CGBuilderTy &Builder, const Stmt *S,
 void CodeGenPGO::valueProfile(CGBuilderTy &Builder, uint32_t ValueKind,
     llvm::Instruction *ValueSite, llvm::Value *ValuePtr) {
 
-  if (!EnableValueProfiling)
+  if (!EnableValueProfiling &&
+      !(ValueKind == llvm::IPVK_IndirectCallTarget &&
+        CGM.getCodeGenOpts().ProfileIndirectCalls))
     return;
 
   if (!ValuePtr || !ValueSite || !Builder.GetInsertBlock())
@@ -95,7 +95,7 @@ private:
   void mapRegionCounters(const Decl *D);
   void computeRegionCounts(const Decl *D);
   void applyFunctionAttributes(llvm::IndexedInstrProfReader *PGOReader,
-                               llvm::Function *Fn);
+                               const Decl *D, llvm::Function *Fn);
   void loadRegionCounts(llvm::IndexedInstrProfReader *PGOReader,
                         bool IsInMainFile);
   bool skipRegionMappingForDecl(const Decl *D);
@@ -789,6 +789,11 @@ static void addPGOAndCoverageFlags(Compilation &C, const Driver &D,
     }
   }
 
+  if ((ProfileGenerateArg || ProfileUseArg) &&
+      Args.hasFlag(options::OPT_fprofile_indirect_calls,
+                   options::OPT_fno_profile_indirect_calls, false))
+    CmdArgs.push_back("-fprofile-indirect-calls");
+
   if (Args.hasArg(options::OPT_ftest_coverage) ||
       Args.hasArg(options::OPT_coverage))
     CmdArgs.push_back("-femit-coverage-notes");
@@ -2040,9 +2045,12 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
       CmdArgs.push_back("-fsyntax-only");
     else if (JA.getType() == types::TY_ModuleFile)
       CmdArgs.push_back("-emit-module-interface");
-    else if (UsePCH)
+    else if (UsePCH) {
       CmdArgs.push_back("-emit-pch");
-    else
+      if (Args.hasFlag(options::OPT_fpch_instantiate_templates,
+                       options::OPT_fno_pch_instantiate_templates, false))
+        CmdArgs.push_back("-fpch-instantiate-templates");
+    } else
       CmdArgs.push_back("-emit-pth");
   } else if (isa<VerifyPCHJobAction>(JA)) {
     CmdArgs.push_back("-verify-pch");
@@ -2251,6 +2259,10 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
                     options::OPT_fno_merge_all_constants))
     CmdArgs.push_back("-fno-merge-all-constants");
 
+  if (Args.hasFlag(options::OPT_ffold_dynamic_initializers,
+                   options::OPT_fno_fold_dynamic_initializers, false))
+    CmdArgs.push_back("-ffold-dynamic-initializers");
+
   // LLVM Code Generator Options.
 
   if (Args.hasArg(options::OPT_frewrite_map_file) ||
@@ -2823,6 +2835,11 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
                                     getToolChain().GetDefaultStandaloneDebug());
   if (DebugInfoKind == codegenoptions::LimitedDebugInfo && NeedFullDebug)
     DebugInfoKind = codegenoptions::FullDebugInfo;
+  // Constructor homing only further limits limited debug info.
+  if (Args.hasFlag(options::OPT_fuse_ctor_homing,
+                   options::OPT_fno_use_ctor_homing, false) &&
+      DebugInfoKind == codegenoptions::LimitedDebugInfo)
+    CmdArgs.push_back("-fuse-ctor-homing");
   RenderDebugEnablingArgs(Args, CmdArgs, DebugInfoKind, DwarfVersion,
                           DebuggerTuning);
 
@@ -3127,6 +3144,11 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
     CmdArgs.push_back(A->getValue());
   }
 
+  if (Arg *A = Args.getLastArg(options::OPT_fconstexpr_cache_entries_EQ)) {
+    CmdArgs.push_back("-fconstexpr-cache-entries");
+    CmdArgs.push_back(A->getValue());
+  }
+
   if (Arg *A = Args.getLastArg(options::OPT_fbracket_depth_EQ)) {
     CmdArgs.push_back("-fbracket-depth");
     CmdArgs.push_back(A->getValue());
@@ -3643,6 +3665,7 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
   Args.AddAllArgs(CmdArgs, options::OPT_fmodules_ignore_macro);
   Args.AddLastArg(CmdArgs, options::OPT_fmodules_prune_interval);
   Args.AddLastArg(CmdArgs, options::OPT_fmodules_prune_after);
+  Args.AddLastArg(CmdArgs, options::OPT_fmodules_prune_size_limit);
 
   Args.AddLastArg(CmdArgs, options::OPT_fbuild_session_timestamp);
 
@@ -3671,6 +3694,7 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
   }
 
   Args.AddLastArg(CmdArgs, options::OPT_fmodules_validate_system_headers);
+  Args.AddLastArg(CmdArgs, options::OPT_fvalidate_ast_input_files_content);
   Args.AddLastArg(CmdArgs, options::OPT_fmodules_disable_diagnostic_validation);
 
   // -faccess-control is default.
@@ -4362,14 +4386,40 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
       isa<CompileJobAction>(JA))
     CmdArgs.push_back("-disable-llvm-passes");
 
+  // With -fparallel-codegen=N, the backend writes N object files, which are
+  // then combined into the requested output by a relocatable link.
+  SmallVector<const char *, 8> CodeGenPartitions;
+  if (Arg *A = Args.getLastArg(options::OPT_fparallel_codegen_EQ)) {
+    StringRef Value = A->getValue();
+    unsigned NumPartitions;
+    const llvm::Triple &T = getToolChain().getTriple();
+    if (Value.getAsInteger(10, NumPartitions) || NumPartitions == 0)
+      D.Diag(diag::err_drv_invalid_int_value) << A->getAsString(Args) << Value;
+    else if (!T.isOSBinFormatELF() && !T.isOSBinFormatMachO())
+      D.Diag(diag::warn_drv_unsupported_opt_for_target)
+          << A->getAsString(Args) << T.getTriple();
+    else if (NumPartitions > 1 && Output.getType() == types::TY_Object &&
+             Output.isFilename() && !Args.hasArg(options::OPT_gsplit_dwarf))
+      for (unsigned I = 0; I != NumPartitions; ++I) {
+        const char *Partition =
+            Args.MakeArgString(D.GetTemporaryPath("partition", "o"));
+        C.addTempFile(Partition);
+        CodeGenPartitions.push_back(Partition);
+      }
+  }
+
   if (Output.getType() == types::TY_Dependencies) {
     // Handled with other dependency code.
   } else if (Output.isFilename()) {
     CmdArgs.push_back("-o");
-    CmdArgs.push_back(Output.getFilename());
+    CmdArgs.push_back(CodeGenPartitions.empty() ? Output.getFilename()
+                                                : CodeGenPartitions.front());
   } else {
     assert(Output.isNothing() && "Invalid output.");
   }
+  for (unsigned I = 1, N = CodeGenPartitions.size(); I < N; ++I)
+    CmdArgs.push_back(Args.MakeArgString(Twine("-fparallel-codegen-output=") +
+                                         CodeGenPartitions[I]));
 
   addDashXForInput(Args, Input, CmdArgs);
 
@@ -4487,6 +4537,18 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
     C.addCommand(llvm::make_unique<Command>(JA, *this, Exec, CmdArgs, Inputs));
   }
 
+  // Combine the objects of the code generation partitions.
+  if (!CodeGenPartitions.empty()) {
+    ArgStringList LinkArgs;
+    LinkArgs.push_back("-r");
+    LinkArgs.push_back("-o");
+    LinkArgs.push_back(Output.getFilename());
+    LinkArgs.append(CodeGenPartitions.begin(), CodeGenPartitions.end());
+    const char *Linker = Args.MakeArgString(getToolChain().GetLinkerPath());
+    C.addCommand(
+        llvm::make_unique<Command>(JA, *this, Linker, LinkArgs, Inputs));
+  }
+
   // Handle the debug info splitting at object creation time if we're
   // creating an object.
   // TODO: Currently only works on linux with newer objcopy.
@@ -4505,6 +4567,11 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
   // do not need to deal with it at all.
   Args.ClaimAllArgs(options::OPT_fpch_preprocess);
 
+  // -fpch-instantiate-templates only affects building the PCH itself; it is
+  // harmless (and expected) on the commands that use the PCH.
+  Args.ClaimAllArgs(options::OPT_fpch_instantiate_templates);
+  Args.ClaimAllArgs(options::OPT_fno_pch_instantiate_templates);
+
   // Claim some arguments which clang doesn't support, but we don't
   // care to warn the user about.
   Args.ClaimAllArgs(options::OPT_clang_ignored_f_Group);
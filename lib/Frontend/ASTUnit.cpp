@@ -15,6 +15,7 @@
 #include "clang/AST/ASTConsumer.h"
 #include "clang/AST/ASTContext.h"
 #include "clang/AST/DeclVisitor.h"
+#include "clang/AST/RecursiveASTVisitor.h"
 #include "clang/AST/StmtVisitor.h"
 #include "clang/AST/TypeOrdering.h"
 #include "clang/Basic/Diagnostic.h"
@@ -37,14 +38,17 @@
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringSet.h"
+#include "llvm/Support/Chrono.h"
 #include "llvm/Support/CrashRecoveryContext.h"
 #include "llvm/Support/Host.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Mutex.h"
 #include "llvm/Support/MutexGuard.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/Timer.h"
 #include "llvm/Support/raw_ostream.h"
 #include <atomic>
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
 
@@ -190,9 +194,11 @@ ASTUnit::ASTUnit(bool _MainFileIsAST)
     OwnsRemappedFileBuffers(true),
     NumStoredDiagnosticsFromDriver(0),
     PreambleRebuildCounter(0),
-    NumWarningsInPreamble(0),
+    NumWarningsInPreamble(0), BuildPreambleInBackground(false),
+    StorePreambleInMemory(false),
     ShouldCacheCodeCompletionResults(false),
     IncludeBriefCommentsInCodeCompletion(false), UserFilesAreVolatile(false),
+    SkipUnchangedFunctionBodies(false),
     CompletionCacheTopLevelHashValue(0),
     PreambleTopLevelHashValue(0),
     CurrentTopLevelHashValue(0),
@@ -209,6 +215,11 @@ ASTUnit::~ASTUnit() {
 
   clearFileLevelDecls();
 
+  // The worker thread only uses its own copies of our state, but don't leave
+  // it running behind us.
+  if (PendingPreamble.valid())
+    PendingPreamble.wait();
+
   // Free the buffers associated with remapped files. We are required to
   // perform this operation here because we explicitly request that the
   // compiler instance *not* free these buffers for each invocation of the
@@ -893,6 +904,10 @@ public:
   // We're not interested in "interesting" decls.
   void HandleInterestingDecl(DeclGroupRef) override {}
 
+  bool shouldSkipFunctionBody(Decl *D) override {
+    return Unit.shouldSkipFunctionBody(D);
+  }
+
   void HandleTopLevelDeclInObjCContainer(DeclGroupRef D) override {
     for (Decl *TopLevelDecl : D)
       handleTopLevelDecl(TopLevelDecl);
@@ -1032,6 +1047,10 @@ bool ASTUnit::Parse(std::shared_ptr<PCHContainerOperations> PCHContainerOps,
 
   Clang->setInvocation(std::make_shared<CompilerInvocation>(*Invocation));
   OriginalSourceFile = Clang->getFrontendOpts().Inputs[0].getFile();
+
+  // Let the parser ask us which function bodies to skip.
+  if (!SkippableFunctionBodies.empty())
+    Clang->getFrontendOpts().SkipFunctionBodies = true;
     
   // Set up diagnostics, capturing any diagnostics that would
   // otherwise be dropped.
@@ -1086,6 +1105,7 @@ bool ASTUnit::Parse(std::shared_ptr<PCHContainerOperations> PCHContainerOps,
   if (OverrideMainBuffer) {
     assert(Preamble && "No preamble was built, but OverrideMainBuffer is not null");
     Preamble->AddImplicitPreamble(Clang->getInvocation(), OverrideMainBuffer.get());
+    Preamble->AddInMemoryPCH(*Clang);
     
     // The stored diagnostic has the old source manager in it; update
     // the locations to refer into the new source manager. Since we've
@@ -1123,12 +1143,17 @@ bool ASTUnit::Parse(std::shared_ptr<PCHContainerOperations> PCHContainerOps,
 
   FailedParseDiagnostics.clear();
 
+  recordMainFileFunctionBodies();
+
   return false;
 
 error:
   // Remove the overridden buffer we used for the preamble.
   SavedMainFileBuffer = nullptr;
 
+  MainFileFunctionBodies.clear();
+  SkippableFunctionBodies.clear();
+
   // Keep the ownership of the data in the ASTUnit because the client may
   // want to see the diagnostics.
   transferASTDataFromCompilerInstance(*Clang);
@@ -1224,9 +1249,41 @@ ASTUnit::getMainBufferWithPrecompiledPreamble(
   if (!Bounds.Size)
     return nullptr;
 
+  // Swap in a preamble that finished building in the background, provided it
+  // is still up to date.
+  if (PendingPreamble.valid() &&
+      PendingPreamble.wait_for(std::chrono::seconds(0)) ==
+          std::future_status::ready) {
+    std::unique_ptr<BackgroundPreamble> Built = PendingPreamble.get();
+    if (Built->Preamble) {
+      // If the inputs changed again while it was being built, the next
+      // reparse starts another build.
+      if (Built->Preamble->CanReuse(PreambleInvocationIn, MainFileBuffer.get(),
+                                    Bounds, VFS.get()))
+        adoptBackgroundPreamble(*Built);
+    } else if (Built->Error != BuildPreambleError::CouldntCreateTempFile &&
+               Built->Error != BuildPreambleError::PreambleIsEmpty) {
+      // The error is likely to repeat (e.g. the preamble no longer compiles),
+      // so stop serving the stale preamble and fall back to the synchronous
+      // path, which reports the errors and retries after some period.
+      Preamble.reset();
+      PreambleDiagnostics.clear();
+      TopLevelDeclsInPreamble.clear();
+      PreambleRebuildCounter = DefaultPreambleRebuildInterval;
+    }
+  }
+
   if (Preamble) {
-    if (Preamble->CanReuse(PreambleInvocationIn, MainFileBuffer.get(), Bounds,
-                           VFS.get())) {
+    bool CanReuse = Preamble->CanReuse(PreambleInvocationIn,
+                                       MainFileBuffer.get(), Bounds, VFS.get());
+    // If only the files included by the preamble have changed, and in ways
+    // that the PCH reader tolerates, we can keep using it while a new one is
+    // built.
+    bool IsStale = !CanReuse && BuildPreambleInBackground &&
+                   Preamble->CanServeStale(PreambleInvocationIn,
+                                           MainFileBuffer.get(), Bounds,
+                                           VFS.get());
+    if (CanReuse || IsStale) {
       // Okay! We can re-use the precompiled preamble.
 
       // Set the state of the diagnostic object to mimic its state
@@ -1236,7 +1293,15 @@ ASTUnit::getMainBufferWithPrecompiledPreamble(
                             PreambleInvocationIn.getDiagnosticOpts());
       getDiagnostics().setNumWarnings(NumWarningsInPreamble);
 
-      PreambleRebuildCounter = 1;
+      if (CanReuse) {
+        PreambleRebuildCounter = 1;
+      } else if (AllowRebuild && !PendingPreamble.valid()) {
+        if (PreambleRebuildCounter > 1)
+          --PreambleRebuildCounter;
+        else
+          startBackgroundPreambleBuild(PCHContainerOps, PreambleInvocationIn,
+                                       *MainFileBuffer, Bounds, VFS);
+      }
       return MainFileBuffer;
     } else {
       Preamble.reset();
@@ -1275,7 +1340,7 @@ ASTUnit::getMainBufferWithPrecompiledPreamble(
 
     llvm::ErrorOr<PrecompiledPreamble> NewPreamble = PrecompiledPreamble::Build(
         PreambleInvocationIn, MainFileBuffer.get(), Bounds, *Diagnostics, VFS,
-        PCHContainerOps, Callbacks);
+        PCHContainerOps, StorePreambleInMemory, Callbacks);
     if (NewPreamble) {
       Preamble = std::move(*NewPreamble);
       PreambleRebuildCounter = 1;
@@ -1321,6 +1386,111 @@ ASTUnit::getMainBufferWithPrecompiledPreamble(
   return MainFileBuffer;
 }
 
+/// \brief The stack size used when building a preamble in the background,
+/// which matches the one libclang uses for parsing.
+static const unsigned BackgroundPreambleStackSize = 8 << 20;
+
+struct ASTUnit::BackgroundPreamble {
+  llvm::Optional<PrecompiledPreamble> Preamble;
+  BuildPreambleError Error = BuildPreambleError::BeginSourceFileFailed;
+  std::vector<serialization::DeclID> TopLevelDeclIDs;
+  unsigned TopLevelHashValue = 0;
+  unsigned NumWarnings = 0;
+  SmallVector<StandaloneDiagnostic, 4> Diagnostics;
+};
+
+void ASTUnit::startBackgroundPreambleBuild(
+    std::shared_ptr<PCHContainerOperations> PCHContainerOps,
+    const CompilerInvocation &PreambleInvocationIn,
+    const llvm::MemoryBuffer &MainFileBuffer, PreambleBounds Bounds,
+    IntrusiveRefCntPtr<vfs::FileSystem> VFS) {
+  assert(!PendingPreamble.valid() && "Preamble is already being built");
+
+  // The worker thread gets its own copy of everything it reads, so that this
+  // unit can keep being reparsed, and its buffers remapped, in the meantime.
+  auto Invocation = std::make_shared<CompilerInvocation>(PreambleInvocationIn);
+  auto Buffers =
+      std::make_shared<std::vector<std::unique_ptr<llvm::MemoryBuffer>>>();
+  PreprocessorOptions &PPOpts = Invocation->getPreprocessorOpts();
+  std::vector<std::pair<std::string, llvm::MemoryBuffer *>> RemappedBuffers;
+  RemappedBuffers.swap(PPOpts.RemappedFileBuffers);
+  for (const auto &RB : RemappedBuffers) {
+    Buffers->push_back(llvm::MemoryBuffer::getMemBufferCopy(
+        RB.second->getBuffer(), RB.second->getBufferIdentifier()));
+    PPOpts.addRemappedFile(RB.first, Buffers->back().get());
+  }
+  PPOpts.RetainRemappedFileBuffers = true;
+  Buffers->push_back(llvm::MemoryBuffer::getMemBufferCopy(
+      MainFileBuffer.getBuffer(), MainFileBuffer.getBufferIdentifier()));
+  const llvm::MemoryBuffer *MainBuffer = Buffers->back().get();
+  bool CaptureDiags = CaptureDiagnostics;
+  bool InMemory = StorePreambleInMemory;
+
+  PendingPreamble = std::async(std::launch::async, [Invocation, Buffers,
+                                                    MainBuffer, Bounds, VFS,
+                                                    PCHContainerOps,
+                                                    CaptureDiags, InMemory]() {
+    auto Result = llvm::make_unique<BackgroundPreamble>();
+    IntrusiveRefCntPtr<DiagnosticsEngine> Diags(
+        new DiagnosticsEngine(new DiagnosticIDs, &Invocation->getDiagnosticOpts(),
+                              new IgnoringDiagConsumer));
+    SmallVector<StoredDiagnostic, 4> StoredDiags;
+    llvm::Optional<CaptureDroppedDiagnostics> Capture;
+    if (CaptureDiags)
+      Capture.emplace(/*RequestCapture=*/true, *Diags, &StoredDiags,
+                      &Result->Diagnostics);
+
+    ASTUnitPreambleCallbacks Callbacks;
+    llvm::CrashRecoveryContext CRC;
+    CRC.RunSafelyOnThread([&]() {
+      llvm::ErrorOr<PrecompiledPreamble> NewPreamble =
+          PrecompiledPreamble::Build(*Invocation, MainBuffer, Bounds, *Diags,
+                                     VFS, PCHContainerOps, InMemory,
+                                     Callbacks);
+      if (!NewPreamble) {
+        Result->Error =
+            static_cast<BuildPreambleError>(NewPreamble.getError().value());
+        return;
+      }
+      Result->Preamble = std::move(*NewPreamble);
+    }, BackgroundPreambleStackSize);
+
+    Result->TopLevelDeclIDs = Callbacks.takeTopLevelDeclIDs();
+    Result->TopLevelHashValue = Callbacks.getHash();
+    Result->NumWarnings = Diags->getNumWarnings();
+    return Result;
+  });
+}
+
+void ASTUnit::adoptBackgroundPreamble(BackgroundPreamble &Built) {
+  assert(Built.Preamble && "Preamble wasn't built");
+  Preamble = std::move(Built.Preamble);
+  PreambleRebuildCounter = 1;
+  PreambleSrcLocCache.clear();
+
+  TopLevelDecls.clear();
+  TopLevelDeclsInPreamble = std::move(Built.TopLevelDeclIDs);
+  PreambleTopLevelHashValue = Built.TopLevelHashValue;
+  NumWarningsInPreamble = Built.NumWarnings;
+  PreambleDiagnostics = std::move(Built.Diagnostics);
+
+  // As when building the preamble synchronously, clear out the completion
+  // cache if the top-level entities have changed.
+  if (CurrentTopLevelHashValue != PreambleTopLevelHashValue) {
+    CompletionCacheTopLevelHashValue = 0;
+    PreambleTopLevelHashValue = CurrentTopLevelHashValue;
+  }
+}
+
+void ASTUnit::setBuildPreambleInBackground(bool Background) {
+  BuildPreambleInBackground = Background && llvm::llvm_is_multithreaded();
+}
+
+void ASTUnit::waitForBackgroundPreamble() const {
+  if (PendingPreamble.valid())
+    PendingPreamble.wait();
+}
+
 void ASTUnit::RealizeTopLevelDeclsFromPreamble() {
   assert(Preamble && "Should only be called when preamble was built");
 
@@ -1631,7 +1801,9 @@ ASTUnit *ASTUnit::LoadFromCommandLine(
     bool CacheCodeCompletionResults, bool IncludeBriefCommentsInCodeCompletion,
     bool AllowPCHWithCompilerErrors, bool SkipFunctionBodies,
     bool SingleFileParse, bool UserFilesAreVolatile, bool ForSerialization,
-    llvm::Optional<StringRef> ModuleFormat, std::unique_ptr<ASTUnit> *ErrAST,
+    bool SkipUnchangedFunctionBodies, bool BuildPreambleInBackground,
+    bool StorePreambleInMemory, llvm::Optional<StringRef> ModuleFormat,
+    std::unique_ptr<ASTUnit> *ErrAST,
     IntrusiveRefCntPtr<vfs::FileSystem> VFS) {
   assert(Diags.get() && "no DiagnosticsEngine was provided");
 
@@ -1689,6 +1861,9 @@ ASTUnit *ASTUnit::LoadFromCommandLine(
   AST->IncludeBriefCommentsInCodeCompletion
     = IncludeBriefCommentsInCodeCompletion;
   AST->UserFilesAreVolatile = UserFilesAreVolatile;
+  AST->SkipUnchangedFunctionBodies = SkipUnchangedFunctionBodies;
+  AST->setBuildPreambleInBackground(BuildPreambleInBackground);
+  AST->StorePreambleInMemory = StorePreambleInMemory;
   AST->NumStoredDiagnosticsFromDriver = StoredDiagnostics.size();
   AST->StoredDiagnostics.swap(StoredDiagnostics);
   AST->Invocation = CI;
@@ -1744,6 +1919,10 @@ bool ASTUnit::Reparse(std::shared_ptr<PCHContainerOperations> PCHContainerOps,
                                                       RemappedFile.second);
   }
 
+  // Work out which function bodies are unaffected by the edits, while the
+  // previous AST is still around.
+  computeSkippableFunctionBodies(*VFS);
+
   // If we have a preamble file lying around, or if we might try to
   // build a precompiled preamble, do so now.
   std::unique_ptr<llvm::MemoryBuffer> OverrideMainBuffer;
@@ -1789,6 +1968,275 @@ void ASTUnit::ResetForParse() {
   clearFileLevelDecls();
 }
 
+/// \brief Determine whether the body of the given function may be skipped
+/// when reparsing, if nothing it depends on has changed.
+static bool isSkippableFunctionDefinition(const FunctionDecl *FD) {
+  // Only consider functions defined at file scope, whose bodies cannot be
+  // needed by anything else: not templates (which may be instantiated), and
+  // not functions whose bodies may be evaluated or used to deduce a type.
+  return FD->getLexicalDeclContext()->getRedeclContext()->isFileContext() &&
+         !FD->isDependentContext() && !FD->isTemplateInstantiation() &&
+         !FD->isConstexpr() && !FD->getReturnType()->isUndeducedType() &&
+         FD->getLocation().isFileID();
+}
+
+/// \brief Determine whether the given source text may change how the code
+/// after it is preprocessed, through a directive, \c _Pragma or
+/// \c __COUNTER__.
+static bool mayAffectLaterPreprocessing(StringRef Text) {
+  return Text.find('#') != StringRef::npos ||
+         Text.find("%:") != StringRef::npos ||
+         Text.find("_Pragma") != StringRef::npos ||
+         Text.find("__COUNTER__") != StringRef::npos;
+}
+
+namespace {
+/// \brief Finds out whether a function body uses declarations whose
+/// diagnostics or instantiation depend on that use.
+class OtherDeclUseFinder : public RecursiveASTVisitor<OtherDeclUseFinder> {
+  bool isInstantiation(QualType T) const {
+    const CXXRecordDecl *RD = T->getAsCXXRecordDecl();
+    return RD && isa<ClassTemplateSpecializationDecl>(RD);
+  }
+
+  bool isInternalOrInstantiated(const ValueDecl *D) const {
+    // Uses of internal declarations keep them from being diagnosed as unused.
+    if (!D->getParentFunctionOrMethod() && !D->isExternallyVisible())
+      return true;
+    if (const auto *FD = dyn_cast<FunctionDecl>(D))
+      return FD->getTemplateSpecializationKind() != TSK_Undeclared;
+    if (const auto *VD = dyn_cast<VarDecl>(D))
+      return VD->getTemplateSpecializationKind() != TSK_Undeclared;
+    return false;
+  }
+
+public:
+  bool Found = false;
+
+  bool VisitExpr(Expr *E) {
+    Found = isInstantiation(E->getType());
+    return !Found;
+  }
+  bool VisitDeclaratorDecl(DeclaratorDecl *D) {
+    Found = isInstantiation(D->getType());
+    return !Found;
+  }
+  bool VisitDeclRefExpr(DeclRefExpr *E) {
+    Found = isInternalOrInstantiated(E->getDecl());
+    return !Found;
+  }
+  bool VisitMemberExpr(MemberExpr *E) {
+    Found = isInternalOrInstantiated(E->getMemberDecl());
+    return !Found;
+  }
+  bool VisitCXXConstructExpr(CXXConstructExpr *E) {
+    Found = isInternalOrInstantiated(E->getConstructor());
+    return !Found;
+  }
+};
+} // end anonymous namespace
+
+void ASTUnit::setSkipUnchangedFunctionBodies(bool Skip) {
+  SkipUnchangedFunctionBodies = Skip;
+  // Remember the function bodies of the current AST, so that the next
+  // reparse can already make use of them.
+  recordMainFileFunctionBodies();
+}
+
+bool ASTUnit::shouldSkipFunctionBody(const Decl *D) const {
+  // The client asked for every function body to be skipped.
+  if (Invocation->getFrontendOpts().SkipFunctionBodies)
+    return true;
+
+  const FunctionDecl *FD = dyn_cast<FunctionDecl>(D);
+  if (SkippableFunctionBodies.empty() || !FD ||
+      !isSkippableFunctionDefinition(FD))
+    return false;
+
+  std::pair<FileID, unsigned> Loc =
+      SourceMgr->getDecomposedLoc(FD->getLocation());
+  return Loc.first == SourceMgr->getMainFileID() &&
+         SkippableFunctionBodies.count(Loc.second);
+}
+
+void ASTUnit::recordMainFileFunctionBodies() {
+  MainFileFunctionBodies.clear();
+  RemappedBufferHashes.clear();
+  llvm::DenseMap<unsigned, FunctionBodyInfo> Skipped;
+  Skipped.swap(SkippableFunctionBodies);
+  if (!SkipUnchangedFunctionBodies || !SourceMgr)
+    return;
+
+  FileID MainFID = SourceMgr->getMainFileID();
+  auto GetMainFileOffset = [&](SourceLocation Loc, unsigned &Offset) {
+    if (Loc.isInvalid())
+      return false;
+    std::pair<FileID, unsigned> Decomposed =
+        SourceMgr->getDecomposedExpansionLoc(Loc);
+    Offset = Decomposed.second;
+    return Decomposed.first == MainFID;
+  };
+
+  // Collect the offsets of the diagnostics reported in the main file.
+  std::vector<unsigned> DiagOffsets;
+  for (const StoredDiagnostic &SD : StoredDiagnostics) {
+    unsigned Offset;
+    if (GetMainFileOffset(SD.getLocation(), Offset))
+      DiagOffsets.push_back(Offset);
+  }
+  std::sort(DiagOffsets.begin(), DiagOffsets.end());
+
+  SmallVector<Decl *, 64> Worklist(TopLevelDecls.rbegin(),
+                                   TopLevelDecls.rend());
+  while (!Worklist.empty()) {
+    Decl *D = Worklist.pop_back_val();
+    if (isa<NamespaceDecl>(D) || isa<LinkageSpecDecl>(D)) {
+      DeclContext *DC = cast<DeclContext>(D);
+      SmallVector<Decl *, 16> Children(DC->decls_begin(), DC->decls_end());
+      Worklist.append(Children.rbegin(), Children.rend());
+      continue;
+    }
+
+    FunctionDecl *FD = dyn_cast<FunctionDecl>(D);
+    unsigned NameOffset;
+    if (!FD || !isSkippableFunctionDefinition(FD) ||
+        !GetMainFileOffset(FD->getLocation(), NameOffset))
+      continue;
+
+    FunctionBodyInfo Info;
+    if (FD->hasSkippedBody()) {
+      // We skipped this body; carry over what we knew about it.
+      auto Known = Skipped.find(NameOffset);
+      if (Known == Skipped.end())
+        continue;
+      Info = Known->second;
+    } else {
+      Stmt *Body = FD->doesThisDeclarationHaveABody() ? FD->getBody() : nullptr;
+      Info.NameOffset = NameOffset;
+      if (!Body || !GetMainFileOffset(Body->getLocStart(), Info.BodyBegin) ||
+          !GetMainFileOffset(Body->getLocEnd(), Info.BodyEnd))
+        continue;
+      auto FirstDiag = std::lower_bound(DiagOffsets.begin(), DiagOffsets.end(),
+                                        Info.NameOffset);
+      Info.HasDiagnostics =
+          FirstDiag != DiagOffsets.end() && *FirstDiag <= Info.BodyEnd;
+      OtherDeclUseFinder Finder;
+      Finder.TraverseStmt(Body);
+      Info.UsesOtherDecls = Finder.Found;
+    }
+    MainFileFunctionBodies.push_back(Info);
+  }
+
+  for (const auto &RB : Invocation->getPreprocessorOpts().RemappedFileBuffers)
+    if (RB.first != getMainFileName())
+      RemappedBufferHashes[RB.first] = llvm::hash_value(RB.second->getBuffer());
+}
+
+void ASTUnit::computeSkippableFunctionBodies(vfs::FileSystem &VFS) {
+  SkippableFunctionBodies.clear();
+  if (!SkipUnchangedFunctionBodies || MainFileFunctionBodies.empty() ||
+      !SourceMgr || !FileMgr)
+    return;
+
+  // The bodies are only unaffected if nothing outside the main file changed.
+  const PreprocessorOptions &PPOpts = Invocation->getPreprocessorOpts();
+  if (!PPOpts.RemappedFiles.empty())
+    return;
+  llvm::StringSet<> RemappedNames;
+  for (const auto &RB : PPOpts.RemappedFileBuffers) {
+    RemappedNames.insert(RB.first);
+    if (RB.first == getMainFileName())
+      continue;
+    auto Known = RemappedBufferHashes.find(RB.first);
+    if (Known == RemappedBufferHashes.end() ||
+        Known->second != llvm::hash_value(RB.second->getBuffer()))
+      return;
+  }
+  if (RemappedNames.size() - RemappedNames.count(getMainFileName()) !=
+      RemappedBufferHashes.size())
+    return;
+
+  const FileEntry *MainFile =
+      SourceMgr->getFileEntryForID(SourceMgr->getMainFileID());
+  SmallVector<const FileEntry *, 64> Files;
+  FileMgr->GetUniqueIDMapping(Files);
+  for (const FileEntry *File : Files) {
+    if (!File || File == MainFile || RemappedNames.count(File->getName()))
+      continue;
+    // Files that only exist in memory, such as an in-memory preamble, cannot
+    // have changed on disk.
+    if (File->getUniqueID() == llvm::sys::fs::UniqueID(0, 0))
+      continue;
+    auto Status = VFS.status(File->getName());
+    if (!Status || Status->getSize() != uint64_t(File->getSize()) ||
+        llvm::sys::toTimeT(Status->getLastModificationTime()) !=
+            File->getModificationTime())
+      return;
+  }
+
+  // Find the part of the main file that changed.
+  std::unique_ptr<llvm::MemoryBuffer> NewBuffer =
+      getBufferForFileHandlingRemapping(*Invocation, &VFS, getMainFileName());
+  if (!NewBuffer)
+    return;
+  StringRef Old = SourceMgr->getBufferData(SourceMgr->getMainFileID());
+  StringRef New = NewBuffer->getBuffer();
+  size_t Prefix = 0, Suffix = 0;
+  size_t Common = std::min(Old.size(), New.size());
+  while (Prefix != Common && Old[Prefix] == New[Prefix])
+    ++Prefix;
+  while (Suffix != Common - Prefix &&
+         Old[Old.size() - Suffix - 1] == New[New.size() - Suffix - 1])
+    ++Suffix;
+  size_t OldEditEnd = Old.size() - Suffix;
+  bool Unchanged = Old.size() == New.size() && Prefix == Old.size();
+
+  // Every edit must fall within a single function body; the other bodies
+  // then mean exactly what they meant before.
+  const FunctionBodyInfo *Edited = nullptr;
+  if (!Unchanged) {
+    for (const FunctionBodyInfo &Info : MainFileFunctionBodies) {
+      if (Info.BodyBegin < Prefix && OldEditEnd <= Info.BodyEnd) {
+        Edited = &Info;
+        break;
+      }
+    }
+    if (!Edited)
+      return;
+  }
+
+  int Delta = int(New.size()) - int(Old.size());
+
+  // The bodies after the edited one are only unaffected if the edit neither
+  // changed the preprocessor state, say by defining a macro that they use,
+  // nor moved them to other lines, which changes their __LINE__.
+  bool SkipAfterEdit = true;
+  if (Edited) {
+    StringRef OldBody = Old.slice(Edited->BodyBegin, Edited->BodyEnd + 1);
+    StringRef NewBody =
+        New.slice(Edited->BodyBegin, Edited->BodyEnd + 1 + Delta);
+    StringRef OldEdit = Old.slice(Prefix, OldEditEnd);
+    StringRef NewEdit = New.slice(Prefix, New.size() - Suffix);
+    SkipAfterEdit = !mayAffectLaterPreprocessing(OldBody) &&
+                    !mayAffectLaterPreprocessing(NewBody) &&
+                    OldEdit.count('\n') == NewEdit.count('\n');
+  }
+
+  for (const FunctionBodyInfo &Info : MainFileFunctionBodies) {
+    if (&Info == Edited || Info.HasDiagnostics || Info.UsesOtherDecls)
+      continue;
+    FunctionBodyInfo Shifted = Info;
+    if (Info.NameOffset >= OldEditEnd && !Unchanged) {
+      if (!SkipAfterEdit)
+        continue;
+      Shifted.NameOffset += Delta;
+      Shifted.BodyBegin += Delta;
+      Shifted.BodyEnd += Delta;
+    }
+    SkippableFunctionBodies[Shifted.NameOffset] = Shifted;
+  }
+}
+
 //----------------------------------------------------------------------------//
 // Code completion
 //----------------------------------------------------------------------------//
@@ -2154,6 +2602,7 @@ void ASTUnit::CodeComplete(
   if (OverrideMainBuffer) {
     assert(Preamble && "No preamble was built, but OverrideMainBuffer is not null");
     Preamble->AddImplicitPreamble(Clang->getInvocation(), OverrideMainBuffer.get());
+    Preamble->AddInMemoryPCH(*Clang);
     OwnedBuffers.push_back(OverrideMainBuffer.release());
   } else {
     PreprocessorOpts.PrecompiledPreambleBytes.first = 0;
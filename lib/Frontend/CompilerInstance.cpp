@@ -37,6 +37,7 @@
 #include "clang/Serialization/ASTReader.h"
 #include "clang/Serialization/GlobalModuleIndex.h"
 #include "llvm/ADT/Statistic.h"
+#include "llvm/ADT/StringSet.h"
 #include "llvm/Support/CrashRecoveryContext.h"
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/FileSystem.h"
@@ -1373,7 +1374,8 @@ static void writeTimestampFile(StringRef TimestampFile) {
 }
 
 /// \brief Prune the module cache of modules that haven't been accessed in
-/// a long time.
+/// a long time, and then of the least recently used ones until the cache
+/// fits within its size limit.
 static void pruneModuleCache(const HeaderSearchOptions &HSOpts) {
   struct stat StatBuf;
   llvm::SmallString<128> TimestampFile;
@@ -1402,6 +1404,18 @@ static void pruneModuleCache(const HeaderSearchOptions &HSOpts) {
   // notice at the same time that the timestamp is out-of-date.
   writeTimestampFile(TimestampFile);
 
+  // The module files that survive age-based pruning, in case we need to
+  // enforce the size limit.
+  struct CachedModuleFile {
+    std::string Path;
+    uint64_t Size;
+    time_t LastUse;
+  };
+  std::vector<CachedModuleFile> RemainingModuleFiles;
+  uint64_t RemainingSize = 0;
+  std::vector<std::string> Directories;
+  llvm::StringSet<> PrunedDirectories;
+
   // Walk the entire module cache, looking for unused module files and module
   // indices.
   std::error_code EC;
@@ -1412,6 +1426,7 @@ static void pruneModuleCache(const HeaderSearchOptions &HSOpts) {
     // If we don't have a directory, there's nothing to look into.
     if (!llvm::sys::fs::is_directory(Dir->path()))
       continue;
+    Directories.push_back(Dir->path());
 
     // Walk all of the files within this directory.
     for (llvm::sys::fs::directory_iterator File(Dir->path(), EC), FileEnd;
@@ -1431,23 +1446,69 @@ static void pruneModuleCache(const HeaderSearchOptions &HSOpts) {
       time_t FileAccessTime = StatBuf.st_atime;
       if (CurrentTime - FileAccessTime <=
               time_t(HSOpts.ModuleCachePruneAfter)) {
+        // Another compilation holds the lock on a module file while it
+        // builds it, so leave those out of the size limit.
+        if (Extension == ".pcm" &&
+            !llvm::sys::fs::exists(File->path() + ".lock")) {
+          // Access times are not kept up to date on many file systems, so
+          // order module files by when they were last built or, with
+          // -fmodules-validate-once-per-build-session, last validated.
+          time_t LastUse = StatBuf.st_mtime;
+          struct stat TimestampStatBuf;
+          if (!::stat((File->path() + ".timestamp").c_str(),
+                      &TimestampStatBuf))
+            LastUse = std::max(LastUse, TimestampStatBuf.st_mtime);
+          RemainingModuleFiles.push_back(
+              {File->path(), uint64_t(StatBuf.st_size), LastUse});
+          RemainingSize += StatBuf.st_size;
+        }
         continue;
       }
 
       // Remove the file.
       llvm::sys::fs::remove(File->path());
+      if (Extension == ".pcm")
+        PrunedDirectories.insert(Dir->path());
 
       // Remove the timestamp file.
       std::string TimpestampFilename = File->path() + ".timestamp";
       llvm::sys::fs::remove(TimpestampFilename);
     }
+  }
 
-    // If we removed all of the files in the directory, remove the directory
-    // itself.
-    if (llvm::sys::fs::directory_iterator(Dir->path(), EC) ==
-            llvm::sys::fs::directory_iterator() && !EC)
-      llvm::sys::fs::remove(Dir->path());
+  // If the module files that are left still exceed the size limit, remove
+  // the least recently used ones until the cache fits.
+  if (HSOpts.ModuleCachePruneSizeLimit &&
+      RemainingSize > HSOpts.ModuleCachePruneSizeLimit) {
+    std::sort(RemainingModuleFiles.begin(), RemainingModuleFiles.end(),
+              [](const CachedModuleFile &LHS, const CachedModuleFile &RHS) {
+                return LHS.LastUse < RHS.LastUse;
+              });
+    for (const CachedModuleFile &File : RemainingModuleFiles) {
+      if (RemainingSize <= HSOpts.ModuleCachePruneSizeLimit)
+        break;
+      if (llvm::sys::fs::remove(File.Path))
+        continue;
+      llvm::sys::fs::remove(File.Path + ".timestamp");
+      PrunedDirectories.insert(llvm::sys::path::parent_path(File.Path));
+      RemainingSize -= File.Size;
+    }
+  }
+
+  // A global module index that names removed module files is out of date;
+  // remove it, so that it is written again once modules are imported from
+  // that directory.
+  for (const auto &Dir : PrunedDirectories) {
+    SmallString<128> IndexPath(Dir.getKey());
+    llvm::sys::path::append(IndexPath, "modules.idx");
+    llvm::sys::fs::remove(IndexPath);
   }
+
+  // Remove the directories that we emptied.
+  for (const std::string &Dir : Directories)
+    if (llvm::sys::fs::directory_iterator(Dir, EC) ==
+            llvm::sys::fs::directory_iterator() && !EC)
+      llvm::sys::fs::remove(Dir);
 }
 
 void CompilerInstance::createModuleManager() {
@@ -928,6 +928,18 @@ void FrontendAction::EndSourceFile() {
   // Finalize the action.
   EndSourceFileAction();
 
+  // Write the AST memory statistics while the AST is still alive.
+  StringRef ASTStatsFile = CI.getFrontendOpts().ASTStatsFile;
+  if (!ASTStatsFile.empty() && CI.hasASTContext()) {
+    std::error_code EC;
+    llvm::raw_fd_ostream OS(ASTStatsFile, EC, llvm::sys::fs::F_Text);
+    if (EC)
+      CI.getDiagnostics().Report(diag::warn_fe_unable_to_open_stats_file)
+          << ASTStatsFile << EC.message();
+    else
+      CI.getASTContext().PrintStatsJSON(OS);
+  }
+
   // Sema references the ast consumer, so reset sema first.
   //
   // FIXME: There is more per-file stuff we could just drop here?
@@ -13,6 +13,7 @@
 
 #include "clang/Frontend/PrecompiledPreamble.h"
 #include "clang/AST/DeclObjC.h"
+#include "clang/Basic/MemoryBufferCache.h"
 #include "clang/Basic/TargetInfo.h"
 #include "clang/Basic/VirtualFileSystem.h"
 #include "clang/Frontend/CompilerInstance.h"
@@ -28,6 +29,7 @@
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Mutex.h"
 #include "llvm/Support/MutexGuard.h"
+#include <atomic>
 
 using namespace clang;
 
@@ -100,8 +102,9 @@ private:
 
 class PrecompilePreambleAction : public ASTFrontendAction {
 public:
-  PrecompilePreambleAction(PreambleCallbacks &Callbacks)
-      : Callbacks(Callbacks) {}
+  PrecompilePreambleAction(std::string *InMemStorage,
+                           PreambleCallbacks &Callbacks)
+      : InMemStorage(InMemStorage), Callbacks(Callbacks) {}
 
   std::unique_ptr<ASTConsumer> CreateASTConsumer(CompilerInstance &CI,
                                                  StringRef InFile) override;
@@ -122,6 +125,7 @@ private:
   friend class PrecompilePreambleConsumer;
 
   bool HasEmittedPreamblePCH = false;
+  std::string *InMemStorage;
   PreambleCallbacks &Callbacks;
 };
 
@@ -167,9 +171,14 @@ PrecompilePreambleAction::CreateASTConsumer(CompilerInstance &CI,
                                             StringRef InFile) {
   std::string Sysroot;
   std::string OutputFile;
-  std::unique_ptr<raw_ostream> OS =
-      GeneratePCHAction::ComputeASTConsumerArguments(CI, InFile, Sysroot,
-                                                     OutputFile);
+  std::unique_ptr<raw_ostream> OS;
+  if (InMemStorage) {
+    Sysroot = CI.getHeaderSearchOpts().Sysroot;
+    OS = llvm::make_unique<llvm::raw_string_ostream>(*InMemStorage);
+  } else {
+    OS = GeneratePCHAction::ComputeASTConsumerArguments(CI, InFile, Sysroot,
+                                                        OutputFile);
+  }
   if (!OS)
     return nullptr;
 
@@ -202,7 +211,7 @@ llvm::ErrorOr<PrecompiledPreamble> PrecompiledPreamble::Build(
     const CompilerInvocation &Invocation,
     const llvm::MemoryBuffer *MainFileBuffer, PreambleBounds Bounds,
     DiagnosticsEngine &Diagnostics, IntrusiveRefCntPtr<vfs::FileSystem> VFS,
-    std::shared_ptr<PCHContainerOperations> PCHContainerOps,
+    std::shared_ptr<PCHContainerOperations> PCHContainerOps, bool StoreInMemory,
     PreambleCallbacks &Callbacks) {
   assert(VFS && "VFS is null");
 
@@ -214,12 +223,17 @@ llvm::ErrorOr<PrecompiledPreamble> PrecompiledPreamble::Build(
   PreprocessorOptions &PreprocessorOpts =
       PreambleInvocation->getPreprocessorOpts();
 
-  // Create a temporary file for the precompiled preamble. In rare
-  // circumstances, this can fail.
-  llvm::ErrorOr<PrecompiledPreamble::TempPCHFile> PreamblePCHFile =
-      PrecompiledPreamble::TempPCHFile::CreateNewPreamblePCHFile();
-  if (!PreamblePCHFile)
-    return BuildPreambleError::CouldntCreateTempFile;
+  // Create a temporary file for the precompiled preamble, unless it is kept in
+  // memory. In rare circumstances, this can fail.
+  llvm::Optional<PrecompiledPreamble::TempPCHFile> PreamblePCHFile;
+  std::string InMemoryPCH;
+  if (!StoreInMemory) {
+    llvm::ErrorOr<PrecompiledPreamble::TempPCHFile> File =
+        PrecompiledPreamble::TempPCHFile::CreateNewPreamblePCHFile();
+    if (!File)
+      return BuildPreambleError::CouldntCreateTempFile;
+    PreamblePCHFile = std::move(*File);
+  }
 
   // Save the preamble text for later; we'll need to compare against it for
   // subsequent reparses.
@@ -230,8 +244,8 @@ llvm::ErrorOr<PrecompiledPreamble> PrecompiledPreamble::Build(
 
   // Tell the compiler invocation to generate a temporary precompiled header.
   FrontendOpts.ProgramAction = frontend::GeneratePCH;
-  // FIXME: Generate the precompiled header into memory?
-  FrontendOpts.OutputFile = PreamblePCHFile->getFilePath();
+  if (PreamblePCHFile)
+    FrontendOpts.OutputFile = PreamblePCHFile->getFilePath();
   PreprocessorOpts.PrecompiledPreambleBytes.first = 0;
   PreprocessorOpts.PrecompiledPreambleBytes.second = false;
 
@@ -301,7 +315,8 @@ llvm::ErrorOr<PrecompiledPreamble> PrecompiledPreamble::Build(
   }
 
   std::unique_ptr<PrecompilePreambleAction> Act;
-  Act.reset(new PrecompilePreambleAction(Callbacks));
+  Act.reset(new PrecompilePreambleAction(
+      StoreInMemory ? &InMemoryPCH : nullptr, Callbacks));
   if (!Act->BeginSourceFile(*Clang.get(), Clang->getFrontendOpts().Inputs[0]))
     return BuildPreambleError::BeginSourceFileFailed;
 
@@ -336,8 +351,9 @@ llvm::ErrorOr<PrecompiledPreamble> PrecompiledPreamble::Build(
   }
 
   return PrecompiledPreamble(
-      std::move(*PreamblePCHFile), std::move(PreambleBytes),
-      PreambleEndsAtStartOfLine, std::move(FilesInPreamble));
+      std::move(PreamblePCHFile), std::move(InMemoryPCH),
+      std::move(PreambleBytes), PreambleEndsAtStartOfLine,
+      std::move(FilesInPreamble));
 }
 
 PreambleBounds PrecompiledPreamble::getBounds() const {
@@ -353,24 +369,30 @@ bool PrecompiledPreamble::CanReuse(const CompilerInvocation &Invocation,
       Bounds.Size <= MainFileBuffer->getBufferSize() &&
       "Buffer is too large. Bounds were calculated from a different buffer?");
 
-  auto PreambleInvocation = std::make_shared<CompilerInvocation>(Invocation);
-  PreprocessorOptions &PreprocessorOpts =
-      PreambleInvocation->getPreprocessorOpts();
-
-  if (!Bounds.Size)
-    return false;
-
   // We've previously computed a preamble. Check whether we have the same
   // preamble now that we did before, and that there's enough space in
   // the main-file buffer within the precompiled preamble to fit the
   // new main file.
-  if (PreambleBytes.size() != Bounds.Size ||
-      PreambleEndsAtStartOfLine != Bounds.PreambleEndsAtStartOfLine ||
-      memcmp(PreambleBytes.data(), MainFileBuffer->getBufferStart(),
-             Bounds.Size) != 0)
+  if (!MatchesMainFile(MainFileBuffer, Bounds))
     return false;
   // The preamble has not changed. We may be able to re-use the precompiled
   // preamble.
+  return FilesInPreambleMatch(Invocation, VFS, /*SizesOnly=*/false);
+}
+
+bool PrecompiledPreamble::CanServeStale(
+    const CompilerInvocation &Invocation,
+    const llvm::MemoryBuffer *MainFileBuffer, PreambleBounds Bounds,
+    vfs::FileSystem *VFS) const {
+  return MatchesMainFile(MainFileBuffer, Bounds) &&
+         FilesInPreambleMatch(Invocation, VFS, /*SizesOnly=*/true);
+}
+
+bool PrecompiledPreamble::FilesInPreambleMatch(
+    const CompilerInvocation &Invocation, vfs::FileSystem *VFS,
+    bool SizesOnly) const {
+  const PreprocessorOptions &PreprocessorOpts =
+      Invocation.getPreprocessorOpts();
 
   // Check that none of the files used by the preamble have changed.
   // First, make a record of those files that have been overridden via
@@ -410,12 +432,22 @@ bool PrecompiledPreamble::CanReuse(const CompilerInvocation &Invocation,
     if (Overridden != OverriddenFiles.end()) {
       // This file was remapped; check whether the newly-mapped file
       // matches up with the previous mapping.
-      if (Overridden->second != F.second)
+      if (SizesOnly) {
+        // Memory buffers are recorded without a modification time.
+        if (F.second.ModTime || Overridden->second.Size != F.second.Size)
+          return false;
+      } else if (Overridden->second != F.second) {
         return false;
+      }
       continue;
     }
 
     // The file was not remapped; check whether it has changed on disk.
+    if (SizesOnly) {
+      if (!F.second.ModTime || Status.getSize() != uint64_t(F.second.Size))
+        return false;
+      continue;
+    }
     if (Status.getSize() != uint64_t(F.second.Size) ||
         llvm::sys::toTimeT(Status.getLastModificationTime()) !=
             F.second.ModTime)
@@ -424,6 +456,18 @@ bool PrecompiledPreamble::CanReuse(const CompilerInvocation &Invocation,
   return true;
 }
 
+bool PrecompiledPreamble::MatchesMainFile(
+    const llvm::MemoryBuffer *MainFileBuffer, PreambleBounds Bounds) const {
+  assert(
+      Bounds.Size <= MainFileBuffer->getBufferSize() &&
+      "Buffer is too large. Bounds were calculated from a different buffer?");
+
+  return Bounds.Size && PreambleBytes.size() == Bounds.Size &&
+         PreambleEndsAtStartOfLine == Bounds.PreambleEndsAtStartOfLine &&
+         memcmp(PreambleBytes.data(), MainFileBuffer->getBufferStart(),
+                Bounds.Size) == 0;
+}
+
 void PrecompiledPreamble::AddImplicitPreamble(
     CompilerInvocation &CI, llvm::MemoryBuffer *MainFileBuffer) const {
   auto &PreprocessorOpts = CI.getPreprocessorOpts();
@@ -431,7 +475,7 @@ void PrecompiledPreamble::AddImplicitPreamble(
   // Configure ImpicitPCHInclude.
   PreprocessorOpts.PrecompiledPreambleBytes.first = PreambleBytes.size();
   PreprocessorOpts.PrecompiledPreambleBytes.second = PreambleEndsAtStartOfLine;
-  PreprocessorOpts.ImplicitPCHInclude = PCHFile.getFilePath();
+  PreprocessorOpts.ImplicitPCHInclude = getPCHPath();
   PreprocessorOpts.DisablePCHValidation = true;
 
   // Remap main file to point to MainFileBuffer.
@@ -439,13 +483,67 @@ void PrecompiledPreamble::AddImplicitPreamble(
   PreprocessorOpts.addRemappedFile(MainFilePath, MainFileBuffer);
 }
 
+namespace {
+/// A memory buffer over the contents of an in-memory PCH, which keeps them
+/// alive for as long as any memory buffer cache refers to them.
+class InMemoryPCHBuffer : public llvm::MemoryBuffer {
+public:
+  InMemoryPCHBuffer(std::shared_ptr<const std::string> Contents,
+                    StringRef Name)
+      : Contents(std::move(Contents)), Name(Name) {
+    init(this->Contents->data(),
+         this->Contents->data() + this->Contents->size(),
+         /*RequiresNullTerminator=*/false);
+  }
+
+  StringRef getBufferIdentifier() const override { return Name; }
+
+  BufferKind getBufferKind() const override { return MemoryBuffer_Malloc; }
+
+private:
+  std::shared_ptr<const std::string> Contents;
+  std::string Name;
+};
+} // namespace
+
+void PrecompiledPreamble::AddInMemoryPCH(CompilerInstance &Clang) const {
+  if (!isStoredInMemory())
+    return;
+
+  // The file manager needs an entry for the PCH, while its contents are found
+  // in the memory buffer cache before any attempt is made to read the file.
+  Clang.getFileManager().getVirtualFile(InMemoryPCHPath, InMemoryPCH->size(),
+                                        /*ModificationTime=*/0);
+
+  // Every preamble is made visible under its own name, so a buffer that is
+  // already cached under this name has the same contents. Buffers of
+  // preambles that have since been rebuilt are never looked up again, and
+  // own their contents until the cache holding them goes away.
+  MemoryBufferCache &PCMCache = Clang.getPCMCache();
+  if (!PCMCache.lookupBuffer(InMemoryPCHPath))
+    PCMCache.addBuffer(InMemoryPCHPath, llvm::make_unique<InMemoryPCHBuffer>(
+                                            InMemoryPCH, InMemoryPCHPath));
+}
+
 PrecompiledPreamble::PrecompiledPreamble(
-    TempPCHFile PCHFile, std::vector<char> PreambleBytes,
-    bool PreambleEndsAtStartOfLine,
+    llvm::Optional<TempPCHFile> PCHFile, std::string InMemoryPCH,
+    std::vector<char> PreambleBytes, bool PreambleEndsAtStartOfLine,
     llvm::StringMap<PreambleFileHash> FilesInPreamble)
-    : PCHFile(std::move(PCHFile)), FilesInPreamble(FilesInPreamble),
+    : PCHFile(std::move(PCHFile)),
+      InMemoryPCH(std::make_shared<const std::string>(std::move(InMemoryPCH))),
+      FilesInPreamble(FilesInPreamble),
       PreambleBytes(std::move(PreambleBytes)),
-      PreambleEndsAtStartOfLine(PreambleEndsAtStartOfLine) {}
+      PreambleEndsAtStartOfLine(PreambleEndsAtStartOfLine) {
+  if (!this->PCHFile) {
+    static std::atomic<unsigned> NextInMemoryPCH(0);
+    InMemoryPCHPath = "/__clang_tmp/___clang_inmemory_preamble_" +
+                      llvm::utostr(NextInMemoryPCH++) + "___.pch";
+  }
+}
+
+llvm::StringRef PrecompiledPreamble::getPCHPath() const {
+  return PCHFile ? PCHFile->getFilePath() : llvm::StringRef(InMemoryPCHPath);
+}
 
 llvm::ErrorOr<PrecompiledPreamble::TempPCHFile>
 PrecompiledPreamble::TempPCHFile::CreateNewPreamblePCHFile() {
@@ -924,18 +924,27 @@ bool Parser::HandlePragmaLoopHint(LoopHint &Hint) {
   // If no option is specified the argument is assumed to be a constant expr.
   bool OptionUnroll = false;
   bool OptionDistribute = false;
+  bool OptionPipelineDisabled = false;
+  bool OptionEnableDisableOnly = false;
   bool StateOption = false;
   if (OptionInfo) { // Pragma Unroll does not specify an option.
     OptionUnroll = OptionInfo->isStr("unroll");
     OptionDistribute = OptionInfo->isStr("distribute");
+    OptionPipelineDisabled = OptionInfo->isStr("pipeline");
+    OptionEnableDisableOnly = llvm::StringSwitch<bool>(OptionInfo->getName())
+                                  .Case("unroll_and_jam", true)
+                                  .Case("vectorize_predicate", true)
+                                  .Default(false);
     StateOption = llvm::StringSwitch<bool>(OptionInfo->getName())
                       .Case("vectorize", true)
                       .Case("interleave", true)
                       .Default(false) ||
-                  OptionUnroll || OptionDistribute;
+                  OptionUnroll || OptionDistribute || OptionPipelineDisabled ||
+                  OptionEnableDisableOnly;
   }
 
-  bool AssumeSafetyArg = !OptionUnroll && !OptionDistribute;
+  bool AssumeSafetyArg = !OptionUnroll && !OptionDistribute &&
+                         !OptionPipelineDisabled && !OptionEnableDisableOnly;
   // Verify loop hint has an argument.
   if (Toks[0].is(tok::eof)) {
     ConsumeAnnotationToken();
@@ -951,16 +960,21 @@ bool Parser::HandlePragmaLoopHint(LoopHint &Hint) {
     SourceLocation StateLoc = Toks[0].getLocation();
     IdentifierInfo *StateInfo = Toks[0].getIdentifierInfo();
 
+    // Software pipelining is on by default, so it can only be disabled.
     bool Valid = StateInfo &&
                  llvm::StringSwitch<bool>(StateInfo->getName())
-                     .Cases("enable", "disable", true)
+                     .Case("enable", !OptionPipelineDisabled)
+                     .Case("disable", true)
                      .Case("full", OptionUnroll)
                      .Case("assume_safety", AssumeSafetyArg)
                      .Default(false);
     if (!Valid) {
-      Diag(Toks[0].getLocation(), diag::err_pragma_invalid_keyword)
-          << /*FullKeyword=*/OptionUnroll
-          << /*AssumeSafetyKeyword=*/AssumeSafetyArg;
+      if (OptionPipelineDisabled)
+        Diag(Toks[0].getLocation(), diag::err_pragma_pipeline_invalid_keyword);
+      else
+        Diag(Toks[0].getLocation(), diag::err_pragma_invalid_keyword)
+            << /*FullKeyword=*/OptionUnroll
+            << /*AssumeSafetyKeyword=*/AssumeSafetyArg;
       return false;
     }
     if (Toks.size() > 2)
@@ -2644,6 +2658,16 @@ static bool ParseLoopHintValue(Preprocessor &PP, Token &Tok, Token PragmaName,
 ///    'vectorize_width' '(' loop-hint-value ')'
 ///    'interleave_count' '(' loop-hint-value ')'
 ///    'unroll_count' '(' loop-hint-value ')'
+///    'distribute' '(' state-hint-keyword ')'
+///    'unroll_and_jam' '(' state-hint-keyword ')'
+///    'unroll_and_jam_count' '(' loop-hint-value ')'
+///    'vectorize_predicate' '(' state-hint-keyword ')'
+///    'pipeline' '(' 'disable' ')'
+///    'pipeline_initiation_interval' '(' loop-hint-value ')'
+///
+///  state-hint-keyword:
+///    'enable'
+///    'disable'
 ///
 ///  loop-hint-keyword:
 ///    'enable'
@@ -2676,6 +2700,14 @@ static bool ParseLoopHintValue(Preprocessor &PP, Token &Tok, Token PragmaName,
 /// compile time.  Specifying unroll(disable) disables unrolling for the
 /// loop. Specifying unroll_count(_value_) instructs llvm to try to unroll the
 /// loop the number of times indicated by the value.
+///
+/// unroll_and_jam(enable) and unroll_and_jam_count(_value_) ask llvm to unroll
+/// the outer loop it precedes and fuse the copies of the inner loop together.
+/// vectorize_predicate(enable) asks the vectorizer to use predicated
+/// instructions for the remainder iterations instead of a scalar epilogue.
+/// pipeline(disable) turns off software pipelining of the loop, and
+/// pipeline_initiation_interval(_value_) asks the software pipeliner to
+/// schedule a new iteration every _value_ cycles.
 void PragmaLoopHintHandler::HandlePragma(Preprocessor &PP,
                                          PragmaIntroducerKind Introducer,
                                          Token &Tok) {
@@ -2703,6 +2735,11 @@ void PragmaLoopHintHandler::HandlePragma(Preprocessor &PP,
                            .Case("vectorize_width", true)
                            .Case("interleave_count", true)
                            .Case("unroll_count", true)
+                           .Case("pipeline", true)
+                           .Case("pipeline_initiation_interval", true)
+                           .Case("unroll_and_jam", true)
+                           .Case("unroll_and_jam_count", true)
+                           .Case("vectorize_predicate", true)
                            .Default(false);
     if (!OptionValid) {
       PP.Diag(Tok.getLocation(), diag::err_pragma_loop_invalid_option)
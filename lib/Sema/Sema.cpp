@@ -93,7 +93,9 @@ Sema::Sema(Preprocessor &pp, ASTContext &ctxt, ASTConsumer &consumer,
       ValueWithBytesObjCTypeMethod(nullptr), NSArrayDecl(nullptr),
       ArrayWithObjectsMethod(nullptr), NSDictionaryDecl(nullptr),
       DictionaryWithObjectsMethod(nullptr), GlobalNewDeleteDeclared(false),
-      TUKind(TUKind), NumSFINAEErrors(0), AccessCheckingSFINAE(false),
+      TUKind(TUKind), NumSFINAEErrors(0),
+      LastDeclSpecTypeSourceInfo(nullptr), NumSharedTypeSourceInfos(0),
+      AccessCheckingSFINAE(false),
       InNonInstantiationSFINAEContext(false), NonInstantiationEntries(0),
       ArgumentPackSubstitutionIndex(-1), CurrentInstantiationScope(nullptr),
       DisableTypoCorrection(false), TyposCorrected(0), AnalysisWarnings(*this),
@@ -363,6 +365,9 @@ void Sema::addExternalSource(ExternalSemaSource *E) {
 void Sema::PrintStats() const {
   llvm::errs() << "\n*** Semantic Analysis Stats:\n";
   llvm::errs() << NumSFINAEErrors << " SFINAE diagnostics trapped.\n";
+  if (getLangOpts().CompactTypeSourceInfo)
+    llvm::errs() << NumSharedTypeSourceInfos
+                 << " declarators shared type source information.\n";
 
   BumpAlloc.PrintStats();
   AnalysisWarnings.PrintStats();
@@ -767,6 +772,12 @@ void Sema::ActOnEndOfTranslationUnit() {
       LateTemplateParserCleanup(OpaqueParser);
 
     CheckDelayedMemberExceptionSpecs();
+  } else if (LangOpts.PCHInstantiateTemplates) {
+    // When asked to, perform the implicit instantiations the PCH needs now,
+    // so that they are serialized along with it and every translation unit
+    // that includes the PCH loads them lazily instead of instantiating them
+    // again. As above, the point of instantiation is the end of the PCH.
+    PerformPendingInstantiations();
   }
 
   DiagnoseUnterminatedPragmaAttribute();
@@ -4054,6 +4054,63 @@ static void handleOptimizeNoneAttr(Sema &S, Decl *D,
     D->addAttr(Optnone);
 }
 
+static void handleOptimizeAttr(Sema &S, Decl *D, const AttributeList &Attr) {
+  if (!checkAttributeAtLeastNumArgs(S, Attr, 1))
+    return;
+
+  SmallVector<StringRef, 4> Options;
+  for (unsigned I = 0, E = Attr.getNumArgs(); I != E; ++I) {
+    StringRef Option;
+    SourceLocation ArgLoc;
+    if (!S.checkStringLiteralArgumentAttr(Attr, I, Option, &ArgLoc))
+      return;
+
+    // Accept both the GCC attribute and command-line spellings.
+    StringRef Normalized = llvm::StringSwitch<StringRef>(Option)
+                               .Cases("O0", "-O0", "O0")
+                               .Cases("O1", "-O1", "O", "-O", "O1")
+                               .Cases("O2", "-O2", "O2")
+                               .Cases("O3", "-O3", "O3")
+                               .Cases("Os", "-Os", "Os")
+                               .Cases("Oz", "-Oz", "Oz")
+                               .Cases("unroll-loops", "-funroll-loops",
+                                      "unroll-loops")
+                               .Cases("no-unroll-loops", "-fno-unroll-loops",
+                                      "no-unroll-loops")
+                               .Default("");
+    if (Normalized.empty()) {
+      S.Diag(ArgLoc, diag::warn_attribute_optimize_unsupported_option)
+          << Option;
+      continue;
+    }
+    Options.push_back(Normalized);
+  }
+  if (Options.empty())
+    return;
+
+  OptimizeAttr *OA = ::new (S.Context)
+      OptimizeAttr(Attr.getRange(), S.Context, Options.data(), Options.size(),
+                   Attr.getAttributeSpellingListIndex());
+
+  // -O0 and -Oz have dedicated attributes that already diagnose conflicts
+  // with always_inline, minsize and optnone; express them that way.
+  char Level = OA->getOptLevel();
+  if (Level == '0') {
+    if (OptimizeNoneAttr *Optnone =
+            S.mergeOptimizeNoneAttr(D, Attr.getRange(), /*Spelling=*/0)) {
+      Optnone->setImplicit(true);
+      D->addAttr(Optnone);
+    }
+  } else if (Level == 'z') {
+    if (MinSizeAttr *MinSize =
+            S.mergeMinSizeAttr(D, Attr.getRange(), /*Spelling=*/0)) {
+      MinSize->setImplicit(true);
+      D->addAttr(MinSize);
+    }
+  }
+  D->addAttr(OA);
+}
+
 static void handleConstantAttr(Sema &S, Decl *D, const AttributeList &Attr) {
   if (checkAttrMutualExclusion<CUDASharedAttr>(S, D, Attr.getRange(),
                                                Attr.getName()))
@@ -6061,6 +6118,9 @@ static void ProcessDeclAttribute(Sema &S, Scope *scope, Decl *D,
   case AttributeList::AT_OptimizeNone:
     handleOptimizeNoneAttr(S, D, Attr);
     break;
+  case AttributeList::AT_Optimize:
+    handleOptimizeAttr(S, D, Attr);
+    break;
   case AttributeList::AT_FlagEnum:
     handleSimpleAttribute<FlagEnumAttr>(S, D, Attr);
     break;
@@ -843,6 +843,7 @@ void OverloadCandidateSet::clear() {
   NumInlineBytesUsed = 0;
   Candidates.clear();
   Functions.clear();
+  ConversionCache.clear();
 }
 
 namespace {
@@ -4965,6 +4966,39 @@ TryCopyInitialization(Sema &S, Expr *From, QualType ToType,
                                /*AllowObjCConversionOnExplicit=*/false);
 }
 
+/// TryCachedCopyInitialization - Compute the implicit conversion sequence
+/// for passing the argument @p From to a parameter of type @p ToType of a
+/// candidate in @p CandidateSet. Candidates of heavily-overloaded functions
+/// and operators tend to share parameter types, so the sequence is computed
+/// once per argument and parameter type and reused for later candidates.
+static ImplicitConversionSequence
+TryCachedCopyInitialization(Sema &S, OverloadCandidateSet &CandidateSet,
+                            Expr *From, QualType ToType,
+                            bool SuppressUserConversions,
+                            bool InOverloadResolution,
+                            bool AllowObjCWritebackConversion,
+                            bool AllowExplicit = false) {
+  // Most sets only ever get one candidate, which has nothing to share its
+  // conversions with.
+  if (CandidateSet.size() < 2)
+    return TryCopyInitialization(S, From, ToType, SuppressUserConversions,
+                                 InOverloadResolution,
+                                 AllowObjCWritebackConversion, AllowExplicit);
+
+  unsigned Flags = SuppressUserConversions | InOverloadResolution << 1 |
+                   AllowObjCWritebackConversion << 2 | AllowExplicit << 3;
+  if (const ImplicitConversionSequence *Cached =
+          CandidateSet.findCachedConversion(From, ToType, Flags))
+    return *Cached;
+
+  ImplicitConversionSequence ICS =
+      TryCopyInitialization(S, From, ToType, SuppressUserConversions,
+                            InOverloadResolution,
+                            AllowObjCWritebackConversion, AllowExplicit);
+  CandidateSet.cacheConversion(From, ToType, Flags, ICS);
+  return ICS;
+}
+
 static bool TryCopyInitialization(const CanQualType FromQTy,
                                   const CanQualType ToQTy,
                                   Sema &S,
@@ -6002,12 +6036,12 @@ Sema::AddOverloadCandidate(FunctionDecl *Function,
       // parameter of F.
       QualType ParamType = Proto->getParamType(ArgIdx);
       Candidate.Conversions[ArgIdx]
-        = TryCopyInitialization(*this, Args[ArgIdx], ParamType,
-                                SuppressUserConversions,
-                                /*InOverloadResolution=*/true,
-                                /*AllowObjCWritebackConversion=*/
-                                  getLangOpts().ObjCAutoRefCount,
-                                AllowExplicit);
+        = TryCachedCopyInitialization(*this, CandidateSet, Args[ArgIdx],
+                                      ParamType, SuppressUserConversions,
+                                      /*InOverloadResolution=*/true,
+                                      /*AllowObjCWritebackConversion=*/
+                                        getLangOpts().ObjCAutoRefCount,
+                                      AllowExplicit);
       if (Candidate.Conversions[ArgIdx].isBad()) {
         Candidate.Viable = false;
         Candidate.FailureKind = ovl_fail_bad_conversion;
@@ -6502,11 +6536,11 @@ Sema::AddMethodCandidate(CXXMethodDecl *Method, DeclAccessPair FoundDecl,
       // parameter of F.
       QualType ParamType = Proto->getParamType(ArgIdx);
       Candidate.Conversions[ArgIdx + 1]
-        = TryCopyInitialization(*this, Args[ArgIdx], ParamType,
-                                SuppressUserConversions,
-                                /*InOverloadResolution=*/true,
-                                /*AllowObjCWritebackConversion=*/
-                                  getLangOpts().ObjCAutoRefCount);
+        = TryCachedCopyInitialization(*this, CandidateSet, Args[ArgIdx],
+                                      ParamType, SuppressUserConversions,
+                                      /*InOverloadResolution=*/true,
+                                      /*AllowObjCWritebackConversion=*/
+                                        getLangOpts().ObjCAutoRefCount);
       if (Candidate.Conversions[ArgIdx + 1].isBad()) {
         Candidate.Viable = false;
         Candidate.FailureKind = ovl_fail_bad_conversion;
@@ -7176,11 +7210,12 @@ void Sema::AddBuiltinCandidate(QualType *ParamTys, ArrayRef<Expr *> Args,
         = TryContextuallyConvertToBool(*this, Args[ArgIdx]);
     } else {
       Candidate.Conversions[ArgIdx]
-        = TryCopyInitialization(*this, Args[ArgIdx], ParamTys[ArgIdx],
-                                ArgIdx == 0 && IsAssignmentOperator,
-                                /*InOverloadResolution=*/false,
-                                /*AllowObjCWritebackConversion=*/
-                                  getLangOpts().ObjCAutoRefCount);
+        = TryCachedCopyInitialization(*this, CandidateSet, Args[ArgIdx],
+                                      ParamTys[ArgIdx],
+                                      ArgIdx == 0 && IsAssignmentOperator,
+                                      /*InOverloadResolution=*/false,
+                                      /*AllowObjCWritebackConversion=*/
+                                        getLangOpts().ObjCAutoRefCount);
     }
     if (Candidate.Conversions[ArgIdx].isBad()) {
       Candidate.Viable = false;
@@ -5378,6 +5378,30 @@ static void fillAtomicQualLoc(AtomicTypeLoc ATL, const DeclaratorChunk &Chunk) {
   ATL.setParensRange(SourceRange());
 }
 
+/// \brief Determine whether the TypeLoc data for the given type, when written
+/// entirely by declaration specifiers, is determined by the locations of those
+/// specifiers alone.
+static bool isDeclSpecLocationOnlyType(QualType T) {
+  while (true) {
+    switch (T->getTypeClass()) {
+    case Type::Builtin:
+    case Type::Record:
+    case Type::Enum:
+    case Type::Typedef:
+    case Type::TemplateTypeParm:
+    case Type::InjectedClassName:
+      return true;
+
+    case Type::Elaborated:
+      T = cast<ElaboratedType>(T)->getNamedType();
+      break;
+
+    default:
+      return false;
+    }
+  }
+}
+
 /// \brief Create and instantiate a TypeSourceInfo with type source information.
 ///
 /// \param T QualType referring to the type as written in source code.
@@ -5389,6 +5413,25 @@ static void fillAtomicQualLoc(AtomicTypeLoc ATL, const DeclaratorChunk &Chunk) {
 TypeSourceInfo *
 Sema::GetTypeSourceInfoForDeclarator(Declarator &D, QualType T,
                                      TypeSourceInfo *ReturnTypeInfo) {
+  // In compact mode, the declarators of a declaration such as 'int x, y;'
+  // whose types are written entirely by the declaration specifiers they share
+  // would get identical type source information, so they share a single
+  // TypeSourceInfo. All of its locations are still the real ones.
+  bool ShareTypeSourceInfo =
+      getLangOpts().CompactTypeSourceInfo && !ReturnTypeInfo &&
+      D.getNumTypeObjects() == 0 &&
+      (D.getContext() == Declarator::FileContext ||
+       D.getContext() == Declarator::MemberContext ||
+       D.getContext() == Declarator::BlockContext) &&
+      D.getDeclSpec().getSourceRange().isValid() &&
+      isDeclSpecLocationOnlyType(T);
+  if (ShareTypeSourceInfo && LastDeclSpecTypeSourceInfo &&
+      LastDeclSpecTypeSourceInfo->getType() == T &&
+      LastDeclSpecTypeSourceInfoRange == D.getDeclSpec().getSourceRange()) {
+    ++NumSharedTypeSourceInfos;
+    return LastDeclSpecTypeSourceInfo;
+  }
+
   TypeSourceInfo *TInfo = Context.CreateTypeSourceInfo(T);
   UnqualTypeLoc CurrTL = TInfo->getTypeLoc().getUnqualifiedLoc();
   const AttributeList *DeclAttrs = D.getAttributes();
@@ -5430,6 +5473,11 @@ Sema::GetTypeSourceInfoForDeclarator(Declarator &D, QualType T,
     TypeSpecLocFiller(Context, D.getDeclSpec()).Visit(CurrTL);
   }
 
+  if (ShareTypeSourceInfo) {
+    LastDeclSpecTypeSourceInfo = TInfo;
+    LastDeclSpecTypeSourceInfoRange = D.getDeclSpec().getSourceRange();
+  }
+
   return TInfo;
 }
 
@@ -28,6 +28,7 @@
 #include "clang/AST/NestedNameSpecifier.h"
 #include "clang/AST/ODRHash.h"
 #include "clang/AST/RawCommentList.h"
+#include "clang/AST/RecordLayout.h"
 #include "clang/AST/Type.h"
 #include "clang/AST/TypeLocVisitor.h"
 #include "clang/AST/UnresolvedSet.h"
@@ -2031,6 +2032,14 @@ ASTReader::readInputFileInfo(ModuleFile &F, unsigned ID) {
   R.TopLevelModuleMap = static_cast<bool>(Record[5]);
   R.Filename = Blob;
   ResolveImportedPath(F, R.Filename);
+
+  // The content hash record immediately follows the input file record.
+  Code = Cursor.ReadCode();
+  Record.clear();
+  Result = Cursor.readRecord(Code, Record);
+  assert(static_cast<InputFileRecordTypes>(Result) == INPUT_FILE_HASH &&
+         "invalid record type for input file hash");
+  R.StoredContentHash = (static_cast<uint64_t>(Record[1]) << 32) | Record[0];
   return R;
 }
 
@@ -2117,12 +2126,29 @@ InputFile ASTReader::getInputFile(ModuleFile &F, unsigned ID, bool Complain) {
 
   bool IsOutOfDate = false;
 
+  // Determine whether the file on disk differs from the one recorded in the
+  // AST file. When only the modification time differs and we recorded a
+  // content hash, compare the contents before declaring the file modified;
+  // this keeps a touched-but-unchanged header from invalidating the AST file.
+  auto HasInputFileChanged = [&]() {
+    if (StoredSize != File->getSize())
+      return true;
+    if (!StoredTime || StoredTime == File->getModificationTime() ||
+        DisableValidation)
+      return false;
+    if (!FI.StoredContentHash ||
+        !PP.getHeaderSearchInfo()
+             .getHeaderSearchOpts()
+             .ValidateASTInputFilesContent)
+      return true;
+    auto Buffer = FileMgr.getBufferForFile(File);
+    if (!Buffer)
+      return true;
+    return hash_value((*Buffer)->getBuffer()) != FI.StoredContentHash;
+  };
+
   // For an overridden file, there is nothing to validate.
-  if (!Overridden && //
-      (StoredSize != File->getSize() ||
-       (StoredTime && StoredTime != File->getModificationTime() &&
-        !DisableValidation)
-       )) {
+  if (!Overridden && HasInputFileChanged()) {
     if (Complain) {
       // Build a list of the PCH imports that got us here (in reverse).
       SmallVector<ModuleFile *, 4> ImportStack(1, &F);
@@ -3177,6 +3203,19 @@ ASTReader::ReadASTBlock(ModuleFile &F, unsigned ClientLoadCapabilities) {
       F.ObjCCategories.swap(Record);
       break;
 
+    case RECORD_LAYOUTS:
+      // Each entry starts with its length, followed by the record's ID.
+      for (unsigned I = 0, N = Record.size(); I != N; I += Record[I]) {
+        if (Record[I] < 2 || Record[I] > N - I) {
+          Error("invalid record layouts record");
+          return Failure;
+        }
+        RecordLayoutOffsets[getGlobalDeclID(F, Record[I + 1])] =
+            std::make_pair(&F, I);
+      }
+      F.RecordLayouts.assign(Record.begin(), Record.end());
+      break;
+
     case CUDA_SPECIAL_DECL_REFS:
       // Later tables overwrite earlier ones.
       // FIXME: Modules will have trouble with this.
@@ -7359,6 +7398,68 @@ void ASTReader::StartTranslationUnit(ASTConsumer *Consumer) {
     DeserializationListener->ReaderInitialized(this);
 }
 
+const ASTRecordLayout *
+ASTReader::getSerializedRecordLayout(const RecordDecl *RD) {
+  auto Pos = RecordLayoutOffsets.find(RD->getGlobalID());
+  if (Pos == RecordLayoutOffsets.end())
+    return nullptr;
+
+  // See ASTWriter::WriteRecordLayouts for the format of each entry.
+  ModuleFile &F = *Pos->second.first;
+  ArrayRef<uint64_t> Record = F.RecordLayouts;
+  unsigned Idx = Pos->second.second + 2;
+  auto ReadCharUnits = [&] {
+    return CharUnits::fromQuantity(static_cast<int64_t>(Record[Idx++]));
+  };
+  auto ReadBase = [&] {
+    return GetLocalDeclAs<CXXRecordDecl>(F, Record[Idx++]);
+  };
+
+  ASTContext &Context = getContext();
+  CharUnits Size = ReadCharUnits();
+  CharUnits DataSize = ReadCharUnits();
+  CharUnits Alignment = ReadCharUnits();
+  CharUnits RequiredAlignment = ReadCharUnits();
+  unsigned NumFields = Record[Idx++];
+  ArrayRef<uint64_t> FieldOffsets = Record.slice(Idx, NumFields);
+  Idx += NumFields;
+
+  if (!Record[Idx++])
+    return new (Context) ASTRecordLayout(Context, Size, Alignment,
+                                         RequiredAlignment, DataSize,
+                                         FieldOffsets);
+
+  CharUnits NonVirtualSize = ReadCharUnits();
+  CharUnits NonVirtualAlignment = ReadCharUnits();
+  CharUnits SizeOfLargestEmptySubobject = ReadCharUnits();
+  CharUnits VBPtrOffset = ReadCharUnits();
+  unsigned Flags = Record[Idx++];
+  const CXXRecordDecl *PrimaryBase = ReadBase();
+  const CXXRecordDecl *BaseSharingVBPtr = ReadBase();
+
+  ASTRecordLayout::BaseOffsetsMapTy BaseOffsets;
+  for (unsigned I = 0, N = Record[Idx++]; I != N; ++I) {
+    const CXXRecordDecl *Base = ReadBase();
+    BaseOffsets[Base] = ReadCharUnits();
+  }
+
+  ASTRecordLayout::VBaseOffsetsMapTy VBaseOffsets;
+  for (unsigned I = 0, N = Record[Idx++]; I != N; ++I) {
+    const CXXRecordDecl *VBase = ReadBase();
+    CharUnits Offset = ReadCharUnits();
+    VBaseOffsets[VBase] = ASTRecordLayout::VBaseInfo(Offset, Record[Idx++]);
+  }
+
+  return new (Context) ASTRecordLayout(
+      Context, Size, Alignment, RequiredAlignment,
+      /*hasOwnVFPtr=*/Flags & 1, /*hasExtendableVFPtr=*/Flags & 2,
+      VBPtrOffset, DataSize, FieldOffsets, NonVirtualSize, NonVirtualAlignment,
+      SizeOfLargestEmptySubobject, PrimaryBase,
+      /*IsPrimaryBaseVirtual=*/Flags & 16, BaseSharingVBPtr,
+      /*EndsWithZeroSizedObject=*/Flags & 4,
+      /*LeadsWithZeroSizedBase=*/Flags & 8, BaseOffsets, VBaseOffsets);
+}
+
 void ASTReader::PrintStats() {
   std::fprintf(stderr, "*** AST File Statistics:\n");
 
@@ -27,6 +27,7 @@
 #include "clang/AST/LambdaCapture.h"
 #include "clang/AST/NestedNameSpecifier.h"
 #include "clang/AST/RawCommentList.h"
+#include "clang/AST/RecordLayout.h"
 #include "clang/AST/TemplateName.h"
 #include "clang/AST/Type.h"
 #include "clang/AST/TypeLocVisitor.h"
@@ -1040,6 +1041,7 @@ void ASTWriter::WriteBlockInfoBlock() {
 
   BLOCK(INPUT_FILES_BLOCK);
   RECORD(INPUT_FILE);
+  RECORD(INPUT_FILE_HASH);
 
   // AST Top-Level Block.
   BLOCK(AST_BLOCK);
@@ -1094,6 +1096,7 @@ void ASTWriter::WriteBlockInfoBlock() {
   RECORD(DELETE_EXPRS_TO_ANALYZE);
   RECORD(CUDA_PRAGMA_FORCE_HOST_DEVICE_DEPTH);
   RECORD(PP_CONDITIONAL_STACK);
+  RECORD(RECORD_LAYOUTS);
 
   // SourceManager Block.
   BLOCK(SOURCE_MANAGER_BLOCK);
@@ -1689,6 +1692,7 @@ namespace  {
   /// \brief An input file.
   struct InputFileEntry {
     const FileEntry *File;
+    const SrcMgr::ContentCache *Cache;
     bool IsSystemFile;
     bool IsTransient;
     bool BufferOverridden;
@@ -1715,6 +1719,13 @@ void ASTWriter::WriteInputFiles(SourceManager &SourceMgr,
   IFAbbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Blob)); // File name
   unsigned IFAbbrevCode = Stream.EmitAbbrev(std::move(IFAbbrev));
 
+  // Create input file hash abbreviation.
+  auto IFHAbbrev = std::make_shared<BitCodeAbbrev>();
+  IFHAbbrev->Add(BitCodeAbbrevOp(INPUT_FILE_HASH));
+  IFHAbbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Fixed, 32)); // Lower 32 bits
+  IFHAbbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Fixed, 32)); // Upper 32 bits
+  unsigned IFHAbbrevCode = Stream.EmitAbbrev(std::move(IFHAbbrev));
+
   // Get all ContentCache objects for files, sorted by whether the file is a
   // system one or not. System files go at the back, users files at the front.
   std::deque<InputFileEntry> SortedFiles;
@@ -1733,6 +1744,7 @@ void ASTWriter::WriteInputFiles(SourceManager &SourceMgr,
 
     InputFileEntry Entry;
     Entry.File = Cache->OrigEntry;
+    Entry.Cache = Cache;
     Entry.IsSystemFile = Cache->IsSystemFile;
     Entry.IsTransient = Cache->IsTransient;
     Entry.BufferOverridden = Cache->BufferOverridden;
@@ -1772,6 +1784,21 @@ void ASTWriter::WriteInputFiles(SourceManager &SourceMgr,
         Entry.IsTopLevelModuleMap};
 
     EmitRecordWithPath(IFAbbrevCode, Record, Entry.File->getName());
+
+    // Emit the content hash for this file, if requested. A hash of zero
+    // means that the content was not hashed.
+    uint64_t ContentHash = 0;
+    if (HSOpts.ValidateASTInputFilesContent && !Entry.BufferOverridden) {
+      bool Invalid = false;
+      llvm::MemoryBuffer *Buffer = Entry.Cache->getBuffer(
+          PP->getDiagnostics(), SourceMgr, SourceLocation(), &Invalid);
+      if (Buffer && !Invalid)
+        ContentHash = hash_value(Buffer->getBuffer());
+    }
+    RecordData::value_type HashRecord[] = {INPUT_FILE_HASH,
+                                           uint32_t(ContentHash),
+                                           uint32_t(ContentHash >> 32)};
+    Stream.EmitRecordWithAbbrev(IFHAbbrevCode, HashRecord);
   }
 
   Stream.ExitBlock();
@@ -2129,11 +2156,13 @@ static void emitBlob(llvm::BitstreamWriter &Stream, StringRef Blob,
   typedef ASTWriter::RecordData::value_type RecordDataType;
 
   // Compress the buffer if possible. We expect that almost all PCM
-  // consumers will not want its contents.
+  // consumers will not want its contents. Buffers that do not shrink are
+  // stored uncompressed: the reader can then reference them in place
+  // instead of decompressing into a copy.
   SmallString<0> CompressedBuffer;
   if (llvm::zlib::isAvailable()) {
     llvm::Error E = llvm::zlib::compress(Blob.drop_back(1), CompressedBuffer);
-    if (!E) {
+    if (!E && CompressedBuffer.size() < Blob.size() - 1) {
       RecordDataType Record[] = {SM_SLOC_BUFFER_BLOB_COMPRESSED,
                                  Blob.size() - 1};
       Stream.EmitRecordWithBlob(SLocBufferBlobCompressedAbbrv, Record,
@@ -3609,6 +3638,7 @@ void ASTWriter::WriteIdentifierTable(Preprocessor &PP,
     // where the user adds new macro definitions when building the AST
     // file.
     SmallVector<const IdentifierInfo *, 128> IIs;
+    IIs.reserve(PP.getIdentifierTable().size());
     for (const auto &ID : PP.getIdentifierTable())
       IIs.push_back(ID.second);
     // Sort the identifiers lexicographically before getting them references so
@@ -3634,8 +3664,11 @@ void ASTWriter::WriteIdentifierTable(Preprocessor &PP,
         Generator.insert(II, ID, Trait);
     }
 
-    // Create the on-disk hash table in a buffer.
+    // Create the on-disk hash table in a buffer. Each entry needs at least
+    // its key, the lengths and the ID, so reserve space up front rather than
+    // growing the buffer repeatedly for large identifier tables.
     SmallString<4096> IdentifierTable;
+    IdentifierTable.reserve(IdentifierIDs.size() * 16);
     uint32_t BucketOffset;
     {
       using namespace llvm::support;
@@ -3857,7 +3890,9 @@ ASTWriter::GenerateNameLookupTable(const DeclContext *ConstDC,
   // names which are visible.
   llvm::SmallSet<DeclarationName, 8> ConstructorNameSet, ConversionNameSet;
 
-  for (auto &Lookup : *DC->buildLookup()) {
+  StoredDeclsMap *Map = DC->buildLookup();
+  Names.reserve(Map->size());
+  for (auto &Lookup : *Map) {
     auto &Name = Lookup.first;
     auto &Result = Lookup.second;
 
@@ -4184,6 +4219,86 @@ void ASTWriter::WriteCUDAPragmas(Sema &SemaRef) {
   }
 }
 
+/// \brief Write the layouts computed for the records declared in this AST
+/// file, so that the translation units using it do not recompute them.
+void ASTWriter::WriteRecordLayouts(ASTContext &Context) {
+  // Order the layouts by declaration ID so that the output does not depend
+  // on the address of the declarations.
+  SmallVector<std::pair<DeclID, const RecordDecl *>, 64> Records;
+  for (const auto &Entry : Context.ASTRecordLayouts) {
+    const RecordDecl *RD = Entry.first;
+    if (!Entry.second || RD->isFromASTFile() || RD->isInvalidDecl())
+      continue;
+    auto ID = DeclIDs.find(RD);
+    if (ID != DeclIDs.end())
+      Records.push_back(std::make_pair(ID->second, RD));
+  }
+  if (Records.empty())
+    return;
+  std::sort(Records.begin(), Records.end(), llvm::less_first());
+
+  // Each layout is
+  //   [Length, RecordID, Size, DataSize, Alignment, RequiredAlignment,
+  //    NumFields, FieldOffsets..., IsCXX]
+  // followed, for C++ records, by
+  //   [NonVirtualSize, NonVirtualAlignment, SizeOfLargestEmptySubobject,
+  //    VBPtrOffset, Flags, PrimaryBaseID, BaseSharingVBPtrID,
+  //    NumBases, (BaseID, Offset)...,
+  //    NumVBases, (VBaseID, Offset, HasVtorDisp)...]
+  RecordData Record;
+  for (const auto &Entry : Records) {
+    const ASTRecordLayout &Layout = *Context.ASTRecordLayouts[Entry.second];
+    unsigned Start = Record.size();
+    Record.push_back(0); // Length, filled in below.
+    Record.push_back(Entry.first);
+    Record.push_back(Layout.Size.getQuantity());
+    Record.push_back(Layout.DataSize.getQuantity());
+    Record.push_back(Layout.Alignment.getQuantity());
+    Record.push_back(Layout.RequiredAlignment.getQuantity());
+    Record.push_back(Layout.FieldOffsets.size());
+    Record.append(Layout.FieldOffsets.begin(), Layout.FieldOffsets.end());
+
+    const ASTRecordLayout::CXXRecordLayoutInfo *CXXInfo = Layout.CXXInfo;
+    Record.push_back(CXXInfo != nullptr);
+    if (CXXInfo) {
+      Record.push_back(CXXInfo->NonVirtualSize.getQuantity());
+      Record.push_back(CXXInfo->NonVirtualAlignment.getQuantity());
+      Record.push_back(CXXInfo->SizeOfLargestEmptySubobject.getQuantity());
+      Record.push_back(CXXInfo->VBPtrOffset.getQuantity());
+      Record.push_back(CXXInfo->HasOwnVFPtr |
+                       CXXInfo->HasExtendableVFPtr << 1 |
+                       CXXInfo->EndsWithZeroSizedObject << 2 |
+                       CXXInfo->LeadsWithZeroSizedBase << 3 |
+                       CXXInfo->PrimaryBase.getInt() << 4);
+      Record.push_back(getDeclID(CXXInfo->PrimaryBase.getPointer()));
+      Record.push_back(getDeclID(CXXInfo->BaseSharingVBPtr));
+
+      SmallVector<std::pair<DeclID, CharUnits>, 4> Bases;
+      for (const auto &Base : CXXInfo->BaseOffsets)
+        Bases.push_back(std::make_pair(getDeclID(Base.first), Base.second));
+      std::sort(Bases.begin(), Bases.end(), llvm::less_first());
+      Record.push_back(Bases.size());
+      for (const auto &Base : Bases) {
+        Record.push_back(Base.first);
+        Record.push_back(Base.second.getQuantity());
+      }
+
+      SmallVector<std::pair<DeclID, ASTRecordLayout::VBaseInfo>, 4> VBases;
+      for (const auto &VBase : CXXInfo->VBaseOffsets)
+        VBases.push_back(std::make_pair(getDeclID(VBase.first), VBase.second));
+      std::sort(VBases.begin(), VBases.end(), llvm::less_first());
+      Record.push_back(VBases.size());
+      for (const auto &VBase : VBases) {
+        Record.push_back(VBase.first);
+        Record.push_back(VBase.second.VBaseOffset.getQuantity());
+        Record.push_back(VBase.second.hasVtorDisp());
+      }
+    }
+    Record[Start] = Record.size() - Start;
+  }
+  Stream.EmitRecord(RECORD_LAYOUTS, Record);
+}
+
 void ASTWriter::WriteObjCCategories() {
   SmallVector<ObjCCategoriesInfo, 2> CategoriesMap;
   RecordData Categories;
@@ -4873,6 +4988,7 @@ ASTFileSignature ASTWriter::WriteASTCore(Sema &SemaRef, StringRef isysroot,
   WriteOpenCLExtensionTypes(SemaRef);
   WriteOpenCLExtensionDecls(SemaRef);
   WriteCUDAPragmas(SemaRef);
+  WriteRecordLayouts(Context);
 
   // If we're emitting a module, write out the submodule information.  
   if (WritingModule)
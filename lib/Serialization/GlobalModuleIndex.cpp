@@ -21,6 +21,7 @@
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/Bitcode/BitstreamReader.h"
 #include "llvm/Bitcode/BitstreamWriter.h"
@@ -33,6 +34,13 @@
 using namespace clang;
 using namespace serialization;
 
+#define DEBUG_TYPE "module-index"
+
+STATISTIC(NumModuleFilesReused,
+          "Number of module files reused from the old global module index");
+STATISTIC(NumModuleFilesLoaded,
+          "Number of module files loaded to build the global module index");
+
 //----------------------------------------------------------------------------//
 // Shared constants
 //----------------------------------------------------------------------------//
@@ -58,7 +66,7 @@ namespace {
 static const char * const IndexFileName = "modules.idx";
 
 /// \brief The global index file version.
-static const unsigned CurrentVersion = 1;
+static const unsigned CurrentVersion = 2;
 
 //----------------------------------------------------------------------------//
 // Global module index reader.
@@ -202,6 +210,10 @@ GlobalModuleIndex::GlobalModuleIndex(std::unique_ptr<llvm::MemoryBuffer> Buffer,
                                       Record.begin() + Idx + NumDeps);
       Idx += NumDeps;
 
+      // Signature
+      for (unsigned I = 0; I != 5; ++I)
+        Modules[ID].Signature[I] = Record[Idx++];
+
       // Make sure we're at the end of the record.
       assert(Idx == Record.size() && "More module info?");
 
@@ -440,6 +452,27 @@ namespace {
     /// \returns true if an error occurred, false otherwise.
     bool loadModuleFile(const FileEntry *File);
 
+    /// \brief Add a module file whose contents are known from a previously
+    /// written index, without loading it.
+    void addIndexedModuleFile(const FileEntry *File,
+                              const ASTFileSignature &Signature,
+                              ArrayRef<const FileEntry *> Dependencies) {
+      ModuleFileInfo &Info = getModuleFileInfo(File);
+      Info.Signature = Signature;
+      for (const FileEntry *Dep : Dependencies) {
+        unsigned DependsOnID = getModuleFileInfo(Dep).ID;
+        getModuleFileInfo(File).Dependencies.push_back(DependsOnID);
+      }
+    }
+
+    /// \brief Note that the given identifier is known to the index, and if
+    /// \p File is non-null, that it is interesting in that module file.
+    void addIndexedIdentifier(StringRef Name, const FileEntry *File) {
+      SmallVector<unsigned, 2> &IDs = InterestingIdentifiers[Name];
+      if (File)
+        IDs.push_back(getModuleFileInfo(File).ID);
+    }
+
     /// \brief Write the index to the given bitstream.
     /// \returns true if an error occurred, false otherwise.
     bool writeIndex(llvm::BitstreamWriter &Stream);
@@ -771,6 +804,9 @@ bool GlobalModuleIndexBuilder::writeIndex(llvm::BitstreamWriter &Stream) {
     // Dependencies
     Record.push_back(M->second.Dependencies.size());
     Record.append(M->second.Dependencies.begin(), M->second.Dependencies.end());
+
+    // Signature
+    Record.append(M->second.Signature.begin(), M->second.Signature.end());
     Stream.EmitRecord(MODULE, Record);
   }
 
@@ -841,7 +877,8 @@ GlobalModuleIndex::writeIndex(FileManager &FileMgr,
   // The module index builder.
   GlobalModuleIndexBuilder Builder(FileMgr, PCHContainerRdr);
 
-  // Load each of the module files.
+  // Collect each of the module files.
+  SmallVector<const FileEntry *, 16> ModuleFiles;
   std::error_code EC;
   for (llvm::sys::fs::directory_iterator D(Path, EC), DEnd;
        D != DEnd && !EC;
@@ -862,9 +899,92 @@ GlobalModuleIndex::writeIndex(FileManager &FileMgr,
     if (!ModuleFile)
       continue;
 
-    // Load this module file.
+    ModuleFiles.push_back(ModuleFile);
+  }
+
+  // If there is an existing index, find the module files that have not
+  // changed since it was written. Their information can be taken from the
+  // index instead of loading them again.
+  llvm::DenseMap<unsigned, const FileEntry *> UnchangedFiles;
+  std::unique_ptr<GlobalModuleIndex> OldIndex(readIndex(Path).first);
+  if (OldIndex) {
+    llvm::StringMap<const FileEntry *> FilesByName;
+    for (const FileEntry *File : ModuleFiles)
+      FilesByName[File->getName()] = File;
+
+    for (unsigned ID = 0, N = OldIndex->Modules.size(); ID != N; ++ID) {
+      ModuleInfo &Info = OldIndex->Modules[ID];
+      if (Info.FileName.empty())
+        continue;
+      auto Known = FilesByName.find(Info.FileName);
+      if (Known != FilesByName.end() &&
+          Known->second->getSize() == Info.Size &&
+          Known->second->getModificationTime() == Info.ModTime)
+        UnchangedFiles[ID] = Known->second;
+    }
+
+    // A module file can only be reused if all of its dependencies are, too;
+    // otherwise we would fail to notice that it is out of date with respect
+    // to a rebuilt dependency.
+    bool Changed = true;
+    while (Changed) {
+      Changed = false;
+      SmallVector<unsigned, 4> Stale;
+      for (auto &Entry : UnchangedFiles)
+        for (unsigned Dep : OldIndex->Modules[Entry.first].Dependencies)
+          if (!UnchangedFiles.count(Dep)) {
+            Stale.push_back(Entry.first);
+            break;
+          }
+      for (unsigned ID : Stale)
+        UnchangedFiles.erase(ID);
+      Changed = !Stale.empty();
+    }
+  }
+
+  // Add the unchanged module files and their identifiers.
+  llvm::SmallPtrSet<const FileEntry *, 16> IndexedFiles;
+  if (!UnchangedFiles.empty()) {
+    for (auto &Entry : UnchangedFiles) {
+      ModuleInfo &Info = OldIndex->Modules[Entry.first];
+      SmallVector<const FileEntry *, 4> Deps;
+      for (unsigned Dep : Info.Dependencies)
+        Deps.push_back(UnchangedFiles[Dep]);
+      Builder.addIndexedModuleFile(Entry.second, Info.Signature, Deps);
+      IndexedFiles.insert(Entry.second);
+      ++NumModuleFilesReused;
+    }
+
+    if (OldIndex->IdentifierIndex) {
+      IdentifierIndexTable &Table =
+          *static_cast<IdentifierIndexTable *>(OldIndex->IdentifierIndex);
+      auto Key = Table.key_begin(), KeyEnd = Table.key_end();
+      auto Data = Table.data_begin();
+      for (; Key != KeyEnd; ++Key, ++Data) {
+        bool Known = false;
+        for (unsigned ID : *Data) {
+          auto File = UnchangedFiles.find(ID);
+          if (File == UnchangedFiles.end())
+            continue;
+          Builder.addIndexedIdentifier(*Key, File->second);
+          Known = true;
+        }
+        if (!Known)
+          Builder.addIndexedIdentifier(*Key, nullptr);
+      }
+    }
+  }
+
+  // We're done with the old index; the new one will replace it.
+  OldIndex.reset();
+
+  // Load each of the remaining module files.
+  for (const FileEntry *ModuleFile : ModuleFiles) {
+    if (IndexedFiles.count(ModuleFile))
+      continue;
     if (Builder.loadModuleFile(ModuleFile))
       return EC_IOError;
+    ++NumModuleFilesLoaded;
   }
 
   // The output buffer, into which the global index will be written.
@@ -0,0 +1,83 @@
+// RUN: %clang_cc1 -triple x86_64-unknown-unknown -emit-llvm -disable-llvm-passes -o - %s | FileCheck %s
+// RUN: %clang_cc1 -triple x86_64-unknown-unknown -emit-llvm -o - %s | FileCheck %s --check-prefix=O0
+// RUN: %clang_cc1 -triple x86_64-unknown-unknown -emit-llvm -O2 -disable-llvm-passes -o - %s | FileCheck %s --check-prefix=O2
+// RUN: %clang_cc1 -triple x86_64-unknown-unknown -emit-llvm -O1 -o - %s | FileCheck %s --check-prefix=O1
+
+// Functions that ask for more optimization than the translation unit are
+// optimized on their own, the rest of the file stays at -O0.
+__attribute__((optimize("O2")))
+int hot(int x) {
+  int y = x * 2;
+  return y + 1;
+}
+// CHECK: define i32 @hot({{.*}}) [[HOT:#[0-9]+]]
+// O0-LABEL: define i32 @hot(
+// O0-NOT: alloca
+// O0: ret i32
+
+int plain(int x) {
+  int y = x * 2;
+  return y + 1;
+}
+// CHECK: define i32 @plain({{.*}}) [[PLAIN:#[0-9]+]]
+// O0-LABEL: define i32 @plain(
+// O0: alloca
+
+__attribute__((optimize("Os")))
+int small(int x) {
+  return x + 1;
+}
+// CHECK: define i32 @small({{.*}}) [[SMALL:#[0-9]+]]
+
+__attribute__((optimize("O0")))
+int none(int x) {
+  return x + 1;
+}
+// O2: define i32 @none({{.*}}) [[O2NONE:#[0-9]+]]
+
+// Loops without an unroll hint of their own follow the attribute.
+__attribute__((optimize("no-unroll-loops")))
+void nounroll(int *List, int Length) {
+  for (int i = 0; i < Length; i++)
+    List[i] = i;
+  // CHECK: br label {{.*}}, !llvm.loop ![[LOOP_1:[0-9]+]]
+
+#pragma clang loop unroll_count(2)
+  for (int i = 0; i < Length; i++)
+    List[i] = i;
+  // CHECK: br label {{.*}}, !llvm.loop ![[LOOP_2:[0-9]+]]
+}
+
+// "unroll-loops" enables the unroller's heuristics rather than forcing every
+// loop to be unrolled, so no loop metadata is attached.
+__attribute__((optimize("O1", "unroll-loops")))
+void unroll(int *List, int Length) {
+  for (int i = 0; i < Length; i++)
+    List[i] = i;
+  // CHECK: define void @unroll({{.*}}) [[UNROLL:#[0-9]+]]
+  // CHECK-NOT: !llvm.loop
+  // CHECK: ret void
+}
+// The -O1 translation unit does not unroll loops, but this function does.
+// O1-LABEL: define void @unroll(
+// O1: unroll_iter
+// O1: ret void
+
+void plainloop(int *List, int Length) {
+  for (int i = 0; i < Length; i++)
+    List[i] = i;
+}
+// O1-LABEL: define void @plainloop(
+// O1-NOT: unroll_iter
+// O1: ret void
+
+// CHECK-DAG: attributes [[HOT]] = { {{.*}}"opt-level"="2"{{.*}} }
+// CHECK-DAG: attributes [[PLAIN]] = { {{.*}}optnone{{.*}} }
+// O2: attributes [[O2NONE]] = { {{.*}}noinline{{.*}}optnone{{.*}} }
+// CHECK-DAG: attributes [[SMALL]] = { {{.*}}optsize{{.*}}"opt-level"="2"{{.*}} }
+// CHECK-DAG: attributes [[UNROLL]] = { {{.*}}"unroll-loops"{{.*}} }
+
+// CHECK: ![[LOOP_1]] = distinct !{![[LOOP_1]], ![[UNROLL_DISABLE:[0-9]+]]}
+// CHECK: ![[UNROLL_DISABLE]] = !{!"llvm.loop.unroll.disable"}
+// CHECK: ![[LOOP_2]] = distinct !{![[LOOP_2]], ![[UNROLL_2:[0-9]+]]}
+// CHECK: ![[UNROLL_2]] = !{!"llvm.loop.unroll.count", i32 2}
@@ -0,0 +1,35 @@
+// REQUIRES: x86-registered-target
+// RUN: %clang_cc1 -triple x86_64-unknown-linux-gnu -S %s -o %t.0.s \
+// RUN:   -fparallel-codegen-output=%t.1.s -fparallel-codegen-output=%t.2.s
+// RUN: FileCheck -check-prefix=LOCAL %s < %t.0.s
+// RUN: FileCheck -check-prefix=LOCAL %s < %t.1.s
+// RUN: FileCheck -check-prefix=LOCAL %s < %t.2.s
+// RUN: cat %t.0.s %t.1.s %t.2.s | FileCheck %s
+
+// Symbols with internal or private linkage must stay local in every
+// partition, since the partitions of different translation units are
+// combined by relocatable links and would otherwise clash.
+// LOCAL-NOT: .globl {{.*}}helper
+// LOCAL-NOT: .globl {{.*}}counter
+// LOCAL-NOT: .globl {{.*}}str
+// LOCAL-NOT: .hidden
+
+// CHECK-DAG: .globl first
+// CHECK-DAG: .globl second
+// CHECK-DAG: .globl third
+// CHECK-DAG: {{^}}helper:
+// CHECK-DAG: {{^}}counter:
+// CHECK-DAG: {{^}}.L.str:
+
+int puts(const char *);
+
+static int counter;
+
+static void helper(void) {
+  ++counter;
+  puts("hello");
+}
+
+void first(void) { helper(); }
+void second(void) { helper(); }
+int third(void) { return 3; }
@@ -0,0 +1,56 @@
+// RUN: %clang_cc1 -emit-llvm -triple x86_64-unknown-linux-gnu -std=c++11 \
+// RUN:   -debug-info-kind=limited -fuse-ctor-homing %s -o - | FileCheck %s
+// RUN: %clang_cc1 -emit-llvm -triple x86_64-unknown-linux-gnu -std=c++11 \
+// RUN:   -debug-info-kind=limited %s -o - | FileCheck %s --check-prefix=LIMITED
+// RUN: %clang_cc1 -emit-llvm -triple x86_64-unknown-linux-gnu -std=c++11 \
+// RUN:   -debug-info-kind=standalone -fuse-ctor-homing %s -o - \
+// RUN:   | FileCheck %s --check-prefix=LIMITED
+
+// The constructor is defined in another translation unit, which emits the
+// definition of the class.
+struct Elsewhere {
+  Elsewhere();
+  int I;
+};
+int useElsewhere(Elsewhere &E) { return E.I; }
+// CHECK-DAG: !DICompositeType(tag: DW_TAG_structure_type, name: "Elsewhere",{{.*}}flags: DIFlagFwdDecl
+// LIMITED-DAG: !DICompositeType(tag: DW_TAG_structure_type, name: "Elsewhere",{{.*}}elements:
+
+// The constructor is defined here, so the definition of the class is too.
+struct Here {
+  Here();
+  int I;
+};
+Here::Here() : I(0) {}
+// CHECK-DAG: !DICompositeType(tag: DW_TAG_structure_type, name: "Here",{{.*}}elements:
+
+// Objects of these classes can be created without calling a constructor
+// that is emitted, so their definitions are emitted wherever they are used.
+struct Aggregate {
+  int I;
+};
+Aggregate A;
+// CHECK-DAG: !DICompositeType(tag: DW_TAG_structure_type, name: "Aggregate",{{.*}}elements:
+
+class Constexpr {
+  int I;
+
+public:
+  constexpr Constexpr() : I(0) {}
+  int get();
+};
+Constexpr C;
+// CHECK-DAG: !DICompositeType(tag: DW_TAG_class_type, name: "Constexpr",{{.*}}elements:
+
+// The only constructor that is not a copy or move constructor is deleted, so
+// no translation unit constructs the class and emits its definition.
+class NoCtor {
+  int I;
+
+public:
+  NoCtor(int) = delete;
+  NoCtor(const NoCtor &);
+  int get();
+};
+int useNoCtor(NoCtor &N) { return N.get(); }
+// CHECK-DAG: !DICompositeType(tag: DW_TAG_class_type, name: "NoCtor",{{.*}}elements:
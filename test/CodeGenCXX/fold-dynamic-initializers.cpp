@@ -0,0 +1,61 @@
+// RUN: %clang_cc1 -std=c++11 -triple x86_64-linux-gnu -ffold-dynamic-initializers -emit-llvm -o - %s | FileCheck %s
+// RUN: %clang_cc1 -std=c++11 -triple x86_64-linux-gnu -emit-llvm -o - %s | FileCheck -check-prefix=NOFOLD %s
+// RUN: %clang_cc1 -std=c++11 -triple x86_64-linux-gnu -ffold-dynamic-initializers -emit-llvm -o /dev/null -Rdynamic-init -verify %s
+// RUN: %clang_cc1 -std=c++11 -triple x86_64-linux-gnu -ffold-dynamic-initializers -pic-level 2 -emit-llvm -o - %s | FileCheck -check-prefix=PIC %s
+
+struct Point {
+  Point(int x, int y) : x(x), y(y) {}
+  int x, y;
+};
+
+// CHECK: @p = global %struct.Point { i32 1, i32 2 }
+// PIC: @p = global %struct.Point { i32 1, i32 2 }
+// NOFOLD: @p = global %struct.Point zeroinitializer
+Point p(1, 2);
+
+struct Segment {
+  Point pts[2];
+};
+
+// CHECK: @s = global %struct.Segment {{.*}}{ i32 1, i32 2 }, %struct.Point { i32 3, i32 4 }
+Segment s = {{Point(1, 2), Point(3, 4)}};
+
+int scale(int v) { return v * 10; }
+// CHECK: @i = global i32 70
+// In a shared library, scale may be interposed by another definition.
+// PIC: @i = global i32 0
+int i = scale(7);
+
+static int scaleLocal(int v) { return v * 10; }
+// CHECK: @l = global i32 30
+// PIC: @l = global i32 30
+int l = scaleLocal(3);
+
+// Initializers that modify other globals, call functions without a
+// definition, or initialize static locals stay dynamic.
+int counter;
+struct Counted {
+  Counted() { ++counter; }
+};
+// CHECK: @c = global %struct.Counted zeroinitializer
+Counted c; // expected-remark {{'c' requires dynamic initialization}}
+
+int external();
+// CHECK: @e = global i32 0
+int e = external(); // expected-remark {{'e' requires dynamic initialization}}
+
+int withStatic() {
+  static int n = external();
+  return n;
+}
+// CHECK: @w = global i32 0
+int w = withStatic(); // expected-remark {{'w' requires dynamic initialization}}
+
+// A weak definition may be replaced at link time.
+__attribute__((weak)) int weakScale(int v) { return v * 10; }
+// CHECK: @wk = global i32 0
+int wk = weakScale(7); // expected-remark {{'wk' requires dynamic initialization}}
+
+// NOFOLD: call void @_ZN5PointC1Eii(%struct.Point* @p, i32 1, i32 2)
+// CHECK-NOT: call void @_ZN5PointC1Eii(%struct.Point* @p
+// CHECK-NOT: call i32 @_Z5scalei(i32 7)
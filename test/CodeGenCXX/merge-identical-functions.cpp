@@ -0,0 +1,32 @@
+// REQUIRES: x86-registered-target
+// RUN: %clang_cc1 -triple x86_64-pc-linux-gnu -O1 -fmerge-identical-functions -emit-llvm -o - -x c++ %s 2>/dev/null | FileCheck %s
+// RUN: %clang_cc1 -triple x86_64-pc-linux-gnu -O1 -fmerge-identical-functions -Rmerge-identical-functions -emit-llvm -o /dev/null -x c++ %s 2>&1 | FileCheck -check-prefix=REMARK %s
+// RUN: %clang_cc1 -triple x86_64-pc-linux-gnu -O1 -emit-llvm -o - -x c++ %s | FileCheck -check-prefix=NOMERGE %s
+
+// Specializations whose bodies do not depend on the pointee type are merged
+// before optimization.
+
+template <typename T> struct Stack {
+  T *Data[16];
+  int Size;
+  __attribute__((noinline)) int push(T *P) {
+    if (Size == 16)
+      return 0;
+    Data[Size++] = P;
+    return Size;
+  }
+};
+
+Stack<int> SI;
+Stack<float> SF;
+
+int f(int *I, float *F) { return SI.push(I) + SF.push(F); }
+
+// One specialization becomes a thunk that calls the other.
+// CHECK: define {{.*}} @_ZN5StackI{{[if]}}E4pushEP{{[if]}}
+// CHECK: tail call i32 @_ZN5StackI{{[if]}}E4pushEP{{[if]}}
+// CHECK-NEXT: ret
+
+// REMARK: remark: merged identical functions before optimization: {{[1-9][0-9]*}} of {{[0-9]+}} instructions removed in 1 of 3 functions
+
+// NOMERGE-NOT: tail call i32 @_ZN5StackI{{[if]}}E4pushEP{{[if]}}
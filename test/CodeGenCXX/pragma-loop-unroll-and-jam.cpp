@@ -0,0 +1,54 @@
+// RUN: %clang_cc1 -triple x86_64-apple-darwin -std=c++11 -emit-llvm -o - %s | FileCheck %s
+
+void unroll_and_jam(int *List, int Length, int Value) {
+  // CHECK-LABEL: define {{.*}} @_Z14unroll_and_jam
+#pragma clang loop unroll_and_jam(enable)
+  for (int i = 0; i < Length; i++) {
+    for (int j = 0; j < Length; j++) {
+      // CHECK-NOT: br label {{.*}}, !llvm.loop
+      List[i * Length + j] = Value;
+    }
+    // CHECK: br label {{.*}}, !llvm.loop ![[LOOP_1:.*]]
+  }
+}
+
+void unroll_and_jam_count(int *List, int Length, int Value) {
+  // CHECK-LABEL: define {{.*}} @_Z20unroll_and_jam_count
+#pragma clang loop unroll_and_jam_count(4)
+  for (int i = 0; i < Length; i++) {
+    for (int j = 0; j < Length; j++) {
+      List[i * Length + j] = Value;
+    }
+    // CHECK: br label {{.*}}, !llvm.loop ![[LOOP_2:.*]]
+  }
+}
+
+void unroll_and_jam_disable(int *List, int Length, int Value) {
+  // CHECK-LABEL: define {{.*}} @_Z22unroll_and_jam_disable
+#pragma clang loop unroll_and_jam(disable)
+  for (int i = 0; i < Length; i++) {
+    for (int j = 0; j < Length; j++) {
+      List[i * Length + j] = Value;
+    }
+    // CHECK: br label {{.*}}, !llvm.loop ![[LOOP_3:.*]]
+  }
+}
+
+void vectorize_predicate(int *List, int Length) {
+  // CHECK-LABEL: define {{.*}} @_Z19vectorize_predicate
+#pragma clang loop vectorize(enable) vectorize_predicate(enable)
+  for (int i = 0; i < Length; i++) {
+    // CHECK: br label {{.*}}, !llvm.loop ![[LOOP_4:.*]]
+    List[i] = i * 2;
+  }
+}
+
+// CHECK: ![[LOOP_1]] = distinct !{![[LOOP_1]], ![[UNROLL_AND_JAM_ENABLE:.*]]}
+// CHECK: ![[UNROLL_AND_JAM_ENABLE]] = !{!"llvm.loop.unroll_and_jam.enable"}
+// CHECK: ![[LOOP_2]] = distinct !{![[LOOP_2]], ![[UNROLL_AND_JAM_4:.*]]}
+// CHECK: ![[UNROLL_AND_JAM_4]] = !{!"llvm.loop.unroll_and_jam.count", i32 4}
+// CHECK: ![[LOOP_3]] = distinct !{![[LOOP_3]], ![[UNROLL_AND_JAM_DISABLE:.*]]}
+// CHECK: ![[UNROLL_AND_JAM_DISABLE]] = !{!"llvm.loop.unroll_and_jam.disable"}
+// CHECK: ![[LOOP_4]] = distinct !{![[LOOP_4]], ![[VECTORIZE_ENABLE:.*]], ![[PREDICATE_ENABLE:.*]]}
+// CHECK: ![[VECTORIZE_ENABLE]] = !{!"llvm.loop.vectorize.enable", i1 true}
+// CHECK: ![[PREDICATE_ENABLE]] = !{!"llvm.loop.vectorize.predicate.enable", i1 true}
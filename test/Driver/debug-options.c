@@ -141,6 +141,15 @@
 // RUN: %clang -### -fdebug-types-section -fno-debug-types-section %s 2>&1 \
 // RUN:        | FileCheck -check-prefix=NOFDTS %s
 //
+// RUN: %clang -### -target x86_64-linux-gnu -g -fuse-ctor-homing %s 2>&1 \
+// RUN:        | FileCheck -check-prefix=CTORHOMING %s
+//
+// RUN: %clang -### -g -fstandalone-debug -fuse-ctor-homing %s 2>&1 \
+// RUN:        | FileCheck -check-prefix=NOCTORHOMING %s
+//
+// RUN: %clang -### -g -fuse-ctor-homing -fno-use-ctor-homing %s 2>&1 \
+// RUN:        | FileCheck -check-prefix=NOCTORHOMING %s
+//
 // RUN: %clang -### -g -gno-column-info %s 2>&1 \
 // RUN:        | FileCheck -check-prefix=NOCI %s
 //
@@ -227,6 +236,10 @@
 //
 // NOFDTS-NOT: "-backend-option" "-generate-type-units"
 //
+// CTORHOMING: "-fuse-ctor-homing"
+//
+// NOCTORHOMING-NOT: "-fuse-ctor-homing"
+//
 // CI: "-dwarf-column-info"
 //
 // NOCI-NOT: "-dwarf-column-info"
@@ -0,0 +1,25 @@
+// RUN: %clang -target x86_64-unknown-linux -fparallel-codegen=3 -c %s -o %t.o -### 2>&1 \
+// RUN:   | FileCheck -check-prefix=CHECK-SPLIT %s
+// CHECK-SPLIT: "-cc1"
+// CHECK-SPLIT-SAME: "-o" "[[P0:[^"]*partition-[^"]*\.o]]"
+// CHECK-SPLIT-SAME: "-fparallel-codegen-output=[[P1:[^"]*partition-[^"]*\.o]]"
+// CHECK-SPLIT-SAME: "-fparallel-codegen-output=[[P2:[^"]*partition-[^"]*\.o]]"
+// CHECK-SPLIT: "-r" "-o" "{{.*}}.o" "[[P0]]" "[[P1]]" "[[P2]]"
+
+// RUN: %clang -target x86_64-unknown-linux -fparallel-codegen=1 -c %s -o %t.o -### 2>&1 \
+// RUN:   | FileCheck -check-prefix=CHECK-NOSPLIT %s
+// RUN: %clang -target x86_64-unknown-linux -fparallel-codegen=3 -S %s -o %t.s -### 2>&1 \
+// RUN:   | FileCheck -check-prefix=CHECK-NOSPLIT %s
+// RUN: %clang -target x86_64-unknown-linux -fparallel-codegen=3 -gsplit-dwarf -c %s -o %t.o -### 2>&1 \
+// RUN:   | FileCheck -check-prefix=CHECK-NOSPLIT %s
+// CHECK-NOSPLIT-NOT: -fparallel-codegen-output
+// CHECK-NOSPLIT-NOT: "-r"
+
+// RUN: %clang -target x86_64-unknown-linux -fparallel-codegen=foo -c %s -### 2>&1 \
+// RUN:   | FileCheck -check-prefix=CHECK-INVALID %s
+// CHECK-INVALID: error: invalid integral value 'foo' in '-fparallel-codegen=foo'
+
+// RUN: %clang -target x86_64-pc-windows-msvc -fparallel-codegen=2 -c %s -### 2>&1 \
+// RUN:   | FileCheck -check-prefix=CHECK-UNSUPPORTED %s
+// CHECK-UNSUPPORTED: warning: optimization flag '-fparallel-codegen=2' is not supported for target 'x86_64-pc-windows-msvc'
+// CHECK-UNSUPPORTED-NOT: -fparallel-codegen-output
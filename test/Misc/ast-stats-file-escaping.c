@@ -0,0 +1,10 @@
+// REQUIRES: shell
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: cp %s '%t/quote"back\slash.c'
+// RUN: %clang_cc1 -fsyntax-only -ast-stats-file=%t/stats.json '%t/quote"back\slash.c'
+// RUN: FileCheck %s < %t/stats.json
+
+// File names are escaped as JSON strings.
+int x;
+
+// CHECK: {"name": "{{.*}}/quote\"back\\slash.c", "decls":
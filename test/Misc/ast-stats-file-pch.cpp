@@ -0,0 +1,24 @@
+// RUN: %clang_cc1 -emit-pch -o %t.pch %s
+// RUN: %clang_cc1 -fsyntax-only -include-pch %t.pch -ast-stats-file=%t.json %s
+// RUN: FileCheck %s < %t.json
+
+// Declarations loaded from the PCH are not counted.
+
+#ifndef HEADER
+#define HEADER
+
+namespace FromPCH {
+struct S { int a; };
+}
+
+#else
+
+int local(FromPCH::S s) { return s.a; }
+
+// CHECK: "decls": {
+// CHECK-NOT: "Namespace"
+// CHECK: "Function": {"count": {{[1-9][0-9]*}}, "bytes": {{[1-9][0-9]*}}}
+// CHECK-NOT: "Namespace"
+// CHECK: "stmts": {
+
+#endif
@@ -0,0 +1,16 @@
+// RUN: %clang_cc1 -fsyntax-only -ast-stats-file=%t.json %s
+// RUN: FileCheck %s < %t.json
+
+struct S { int a, b; };
+int f(S s) { return s.a + s.b; }
+
+// CHECK: "allocated_bytes": {{[1-9][0-9]*}},
+// CHECK: "types": {
+// CHECK: "Record": {"count": {{[1-9][0-9]*}}, "bytes": {{[1-9][0-9]*}}}
+// CHECK: "decls": {
+// CHECK: "CXXRecord": {"count": {{[1-9][0-9]*}}, "bytes": {{[1-9][0-9]*}}}
+// CHECK: "Field": {"count": {{[1-9][0-9]*}}, "bytes": {{[1-9][0-9]*}}}
+// CHECK: "stmts": {
+// CHECK: "ReturnStmt": {"count": 1, "bytes": {{[1-9][0-9]*}}}
+// CHECK: "files": [
+// CHECK: {"name": "{{.*}}ast-stats-file.cpp", "decls": {{[1-9][0-9]*}}, "decl_bytes": {{[1-9][0-9]*}}, "stmts": {{[1-9][0-9]*}}, "stmt_bytes": {{[1-9][0-9]*}}}
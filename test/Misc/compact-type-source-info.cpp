@@ -0,0 +1,50 @@
+// RUN: %clang_cc1 -fsyntax-only -fcompact-type-source-info -verify %s
+// RUN: %clang_cc1 -fsyntax-only -fcompact-type-source-info -print-stats %s 2>&1 | FileCheck %s
+// RUN: %clang_cc1 -fsyntax-only -print-stats %s 2>&1 | FileCheck %s --check-prefix=DEFAULT
+
+// Declaration ranges, type locations and diagnostics are the same in both
+// modes.
+// RUN: %clang_cc1 -ast-dump %s | sed -e 's/0x[0-9a-f]*//g' > %t.default.ast
+// RUN: %clang_cc1 -fcompact-type-source-info -ast-dump %s | sed -e 's/0x[0-9a-f]*//g' > %t.compact.ast
+// RUN: diff %t.default.ast %t.compact.ast
+// RUN: not %clang_cc1 -fsyntax-only -fdiagnostics-print-source-range-info -DERRORS %s 2> %t.default.diags
+// RUN: not %clang_cc1 -fsyntax-only -fdiagnostics-print-source-range-info -fcompact-type-source-info -DERRORS %s 2> %t.compact.diags
+// RUN: diff %t.default.diags %t.compact.diags
+// RUN: FileCheck %s --check-prefix=DIAGS < %t.compact.diags
+
+// expected-no-diagnostics
+
+namespace N { struct S { int a; const S *next; }; }
+typedef N::S T;
+
+int x, y, z;
+N::S s1, s2;
+const T *p, *q; // Declarators with their own type locations are not shared.
+void f(int, const N::S &, T *);
+
+struct U {
+  T first, last;
+  unsigned (*fn)(int);
+};
+
+template <typename X> struct W { X a, b; };
+W<int> w;
+
+void g() {
+  unsigned i, j;
+  f(i, s1, &s2);
+}
+
+#ifdef ERRORS
+int e1 = "str", e2 = "str";
+
+template <typename X> void h() { X a, b; }
+template void h<void>();
+#endif
+
+// CHECK: 6 declarators shared type source information.
+// DEFAULT-NOT: shared type source information
+
+// DIAGS: cannot initialize a variable of type 'int'
+// DIAGS: variable has incomplete type 'void'
+// DIAGS: in instantiation of function template specialization 'h<void>'
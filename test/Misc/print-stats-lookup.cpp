@@ -0,0 +1,11 @@
+// RUN: %clang_cc1 -fsyntax-only -print-stats %s 2>&1 | FileCheck %s
+
+namespace N {
+  void f(int);
+  void f(double);
+  int g;
+}
+int x = N::g;
+
+// CHECK: name lookup tables, {{[0-9]+}} names, {{[1-9][0-9]*}} with multiple declarations
+// CHECK: Total bytes in name lookup tables = {{[1-9][0-9]*}}
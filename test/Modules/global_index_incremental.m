@@ -0,0 +1,21 @@
+// RUN: rm -rf %t
+// Build Module and create the global module index.
+// RUN: %clang_cc1 -fmodules-cache-path=%t -fdisable-module-hash -fmodules -fimplicit-module-maps -F %S/Inputs %s -verify
+// RUN: ls %t | grep modules.idx
+// Add DependsOnModule to the cache; the index is updated, reusing the entries
+// for the module files that did not change.
+// RUN: %clang_cc1 -fmodules-cache-path=%t -fdisable-module-hash -fmodules -fimplicit-module-maps -F %S/Inputs %s -verify -DDEPENDS_ON_MODULE
+// Use the updated index for both the reused and the new module files.
+// RUN: %clang_cc1 -fmodules-cache-path=%t -fdisable-module-hash -fmodules -fimplicit-module-maps -F %S/Inputs %s -verify -DDEPENDS_ON_MODULE -print-stats 2>&1 | FileCheck %s
+
+// expected-no-diagnostics
+#ifdef DEPENDS_ON_MODULE
+@import DependsOnModule;
+#endif
+@import Module;
+
+// CHECK: *** Global Module Index Statistics:
+
+int *get_sub() {
+  return Module_Sub;
+}
@@ -0,0 +1,19 @@
+// REQUIRES: asserts
+// RUN: rm -rf %t
+// Build Module and create the global module index from scratch.
+// RUN: %clang_cc1 -fmodules-cache-path=%t -fdisable-module-hash -fmodules -fimplicit-module-maps -F %S/Inputs %s -verify -print-stats 2>&1 | FileCheck %s --check-prefix=INITIAL
+// Add DependsOnModule to the cache. Only its module file is loaded; the entry
+// for Module is copied from the previous index.
+// RUN: %clang_cc1 -fmodules-cache-path=%t -fdisable-module-hash -fmodules -fimplicit-module-maps -F %S/Inputs %s -verify -DDEPENDS_ON_MODULE -print-stats 2>&1 | FileCheck %s --check-prefix=UPDATE
+
+// expected-no-diagnostics
+#ifdef DEPENDS_ON_MODULE
+@import DependsOnModule;
+#endif
+@import Module;
+
+// INITIAL: 1 module-index - Number of module files loaded to build the global module index
+// INITIAL-NOT: module-index - Number of module files reused
+
+// UPDATE-DAG: 1 module-index - Number of module files loaded to build the global module index
+// UPDATE-DAG: 1 module-index - Number of module files reused from the old global module index
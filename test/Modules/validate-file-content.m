@@ -0,0 +1,35 @@
+// REQUIRES: shell
+//
+// RUN: rm -rf %t
+// RUN: mkdir -p %t/Inputs %t/ModuleCache
+// RUN: echo 'int foo(void);' > %t/Inputs/foo.h
+// RUN: echo 'module Foo { header "foo.h" }' > %t/Inputs/module.map
+
+////
+// Build a module that records the content hash of its inputs.
+// RUN: %clang_cc1 -I %t/Inputs -fmodules -fimplicit-module-maps -fmodules-cache-path=%t/ModuleCache -fdisable-module-hash -fvalidate-ast-input-files-content -fsyntax-only %s
+// RUN: cp %t/ModuleCache/Foo.pcm %t/Foo.pcm.saved
+
+////
+// Change only the modification time of the header. The contents still match
+// the recorded hash, so the module should not be rebuilt.
+// RUN: touch -m -t 200001010000 %t/Inputs/foo.h
+// RUN: %clang_cc1 -I %t/Inputs -fmodules -fimplicit-module-maps -fmodules-cache-path=%t/ModuleCache -fdisable-module-hash -fvalidate-ast-input-files-content -fsyntax-only %s
+// RUN: diff %t/ModuleCache/Foo.pcm %t/Foo.pcm.saved
+
+////
+// Without -fvalidate-ast-input-files-content the timestamp mismatch alone
+// forces a rebuild.
+// RUN: %clang_cc1 -I %t/Inputs -fmodules -fimplicit-module-maps -fmodules-cache-path=%t/ModuleCache -fdisable-module-hash -fsyntax-only %s
+// RUN: not diff %t/ModuleCache/Foo.pcm %t/Foo.pcm.saved
+
+////
+// Changing the contents without changing the size is still detected.
+// RUN: rm -rf %t/ModuleCache
+// RUN: %clang_cc1 -I %t/Inputs -fmodules -fimplicit-module-maps -fmodules-cache-path=%t/ModuleCache -fdisable-module-hash -fvalidate-ast-input-files-content -fsyntax-only %s
+// RUN: cp %t/ModuleCache/Foo.pcm %t/Foo.pcm.saved
+// RUN: echo 'int bar(void);' > %t/Inputs/foo.h
+// RUN: %clang_cc1 -I %t/Inputs -fmodules -fimplicit-module-maps -fmodules-cache-path=%t/ModuleCache -fdisable-module-hash -fvalidate-ast-input-files-content -fsyntax-only %s
+// RUN: not diff %t/ModuleCache/Foo.pcm %t/Foo.pcm.saved
+
+@import Foo;
@@ -0,0 +1,56 @@
+// Without -fpch-instantiate-templates, pending instantiations are left to the
+// translation units using the PCH.
+// RUN: %clang_cc1 -triple %itanium_abi_triple -x c++-header -emit-pch -o %t.1 %s -DBAD_INSTANTIATION -verify
+// RUN: %clang_cc1 -triple %itanium_abi_triple -x c++-header -emit-pch -o %t.4 %s
+// RUN: %clang_cc1 -triple %itanium_abi_triple -x ast -ast-dump-all %t.4 | FileCheck %s --check-prefix=NOINST
+//
+// With it, they are performed (and diagnosed) while building the PCH, and the
+// instantiated definitions are serialized for use by the translation unit.
+// RUN: %clang_cc1 -triple %itanium_abi_triple -x c++-header -emit-pch -o %t.2 %s -DBAD_INSTANTIATION -DEXPECT_ERRORS -fpch-instantiate-templates -verify
+// RUN: %clang_cc1 -triple %itanium_abi_triple -x c++-header -emit-pch -o %t.3 %s -fpch-instantiate-templates
+// RUN: %clang_cc1 -triple %itanium_abi_triple -x ast -ast-dump-all %t.3 | FileCheck %s --check-prefix=INST
+// RUN: %clang_cc1 -triple %itanium_abi_triple -include-pch %t.3 -emit-llvm -o - %s | FileCheck %s
+
+#ifndef HEADER_INCLUDED
+#define HEADER_INCLUDED
+
+template <typename T> struct S {
+  static T get() { return T(42); }
+};
+
+inline int use() { return S<int>::get(); }
+
+#ifdef BAD_INSTANTIATION
+template <typename T> struct Bad {
+  static void f() { T::error(); }
+};
+
+inline void useBad() { Bad<int>::f(); }
+
+#ifdef EXPECT_ERRORS
+// expected-error@-6 {{type 'int' cannot be used prior to '::' because it has no members}}
+// expected-note@-4 {{in instantiation of member function 'Bad<int>::f' requested here}}
+#else
+// expected-no-diagnostics
+#endif
+#endif
+
+#else
+
+int main() { return use(); }
+
+// CHECK: define linkonce_odr {{.*}}i32 @_ZN1SIiE3getEv
+
+// The PCH only contains the body of S<int>::get if it was instantiated
+// while building the PCH.
+// INST: ClassTemplateSpecializationDecl {{.*}} struct S definition
+// INST: CXXMethodDecl {{.*}} get 'int {{.*}}'
+// INST-NEXT: CompoundStmt
+// INST: FunctionDecl {{.*}} use
+
+// NOINST: ClassTemplateSpecializationDecl {{.*}} struct S definition
+// NOINST: CXXMethodDecl {{.*}} get 'int {{.*}}'
+// NOINST-NOT: CompoundStmt
+// NOINST: FunctionDecl {{.*}} use
+
+#endif
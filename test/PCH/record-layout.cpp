@@ -0,0 +1,64 @@
+// Test this without pch.
+// RUN: %clang_cc1 -triple x86_64-unknown-linux-gnu -include %s -verify %s
+// RUN: %clang_cc1 -triple i686-pc-win32 -include %s -verify %s
+
+// Test with pch.
+// RUN: %clang_cc1 -triple x86_64-unknown-linux-gnu -emit-pch -o %t %s
+// RUN: %clang_cc1 -triple x86_64-unknown-linux-gnu -include-pch %t -verify %s
+// RUN: %clang_cc1 -triple x86_64-unknown-linux-gnu -include-pch %t \
+// RUN:   -fsyntax-only -fdump-record-layouts %s | FileCheck %s
+// RUN: %clang_cc1 -triple i686-pc-win32 -emit-pch -o %t.ms %s
+// RUN: %clang_cc1 -triple i686-pc-win32 -include-pch %t.ms -verify %s
+
+// expected-no-diagnostics
+
+#ifndef HEADER
+#define HEADER
+
+struct Plain { char c; int i; short s; };
+struct Empty {};
+struct A { virtual void f(); int a; };
+struct B : virtual A { char b; };
+struct C : Empty, B { short c; };
+
+// Lay out the records while building the PCH.
+static_assert(sizeof(Plain) == 12, "");
+static_assert(sizeof(C) > sizeof(B), "");
+
+#else
+
+static_assert(sizeof(Plain) == 12, "");
+static_assert(alignof(Plain) == 4, "");
+static_assert(__builtin_offsetof(Plain, i) == 4, "");
+static_assert(__builtin_offsetof(Plain, s) == 8, "");
+
+#ifdef _WIN32
+static_assert(sizeof(A) == 8, "");
+static_assert(sizeof(B) == 16, "");
+#else
+static_assert(sizeof(A) == 16, "");
+static_assert(sizeof(B) == 32, "");
+static_assert(sizeof(C) == 32, "");
+#endif
+
+// CHECK: *** Dumping AST Record Layout
+// CHECK: 0 | struct Plain
+// CHECK: 4 | int i
+// CHECK: 8 | short s
+// CHECK: [sizeof=12, dsize=12, align=4
+
+// CHECK: *** Dumping AST Record Layout
+// CHECK: 0 | struct A
+// CHECK: 0 | (A vtable pointer)
+// CHECK: 8 | int a
+// CHECK: [sizeof=16, dsize=12, align=8
+
+// CHECK: *** Dumping AST Record Layout
+// CHECK: 0 | struct B
+// CHECK: 0 | (B vtable pointer)
+// CHECK: 8 | char b
+// CHECK: 16 | struct A (virtual base)
+// CHECK: [sizeof=32, dsize={{[0-9]+}}, align=8
+// CHECK: nvsize=9, nvalign=8]
+
+#endif
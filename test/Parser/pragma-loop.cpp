@@ -126,6 +126,19 @@ void test(int *List, int Length) {
     VList[j] = List[j];
   }
 
+#pragma clang loop unroll_and_jam(enable) unroll_and_jam_count(4)
+#pragma clang loop vectorize_predicate(enable)
+#pragma clang loop pipeline_initiation_interval(10)
+  for (int j : VList) {
+    VList[j] = List[j];
+  }
+
+#pragma clang loop unroll_and_jam(disable) vectorize_predicate(disable)
+#pragma clang loop pipeline(disable)
+  for (int j : VList) {
+    VList[j] = List[j];
+  }
+
   test_nontype_template_param<4, 8>(List, Length);
 
 /* expected-error {{expected '('}} */ #pragma clang loop vectorize
@@ -147,7 +160,7 @@ void test(int *List, int Length) {
 /* expected-error {{missing argument; expected 'enable', 'full' or 'disable'}} */ #pragma clang loop unroll()
 /* expected-error {{missing argument; expected 'enable' or 'disable'}} */ #pragma clang loop distribute()
 
-/* expected-error {{missing option; expected vectorize, vectorize_width, interleave, interleave_count, unroll, unroll_count, or distribute}} */ #pragma clang loop
+/* expected-error {{missing option; expected vectorize, vectorize_width, interleave, interleave_count, unroll, unroll_count, distribute, pipeline, pipeline_initiation_interval, unroll_and_jam, unroll_and_jam_count, or vectorize_predicate}} */ #pragma clang loop
 /* expected-error {{invalid option 'badkeyword'}} */ #pragma clang loop badkeyword
 /* expected-error {{invalid option 'badkeyword'}} */ #pragma clang loop badkeyword(enable)
 /* expected-error {{invalid option 'badkeyword'}} */ #pragma clang loop vectorize(enable) badkeyword(4)
@@ -201,6 +214,11 @@ const int VV = 4;
 /* expected-error {{invalid argument; expected 'enable', 'assume_safety' or 'disable'}} */ #pragma clang loop interleave(badidentifier)
 /* expected-error {{invalid argument; expected 'enable', 'full' or 'disable'}} */ #pragma clang loop unroll(badidentifier)
 /* expected-error {{invalid argument; expected 'enable' or 'disable'}} */ #pragma clang loop distribute(badidentifier)
+/* expected-error {{invalid argument; expected 'enable' or 'disable'}} */ #pragma clang loop unroll_and_jam(full)
+/* expected-error {{invalid argument; expected 'enable' or 'disable'}} */ #pragma clang loop vectorize_predicate(assume_safety)
+/* expected-error {{invalid argument; expected 'disable'}} */ #pragma clang loop pipeline(enable)
+/* expected-error {{invalid value '0'; must be positive}} */ #pragma clang loop pipeline_initiation_interval(0)
+/* expected-error {{invalid value '0'; must be positive}} */ #pragma clang loop unroll_and_jam_count(0)
   while (i-7 < Length) {
     List[i] = i;
   }
@@ -249,6 +267,10 @@ const int VV = 4;
 #pragma clang loop unroll(disable)
 /* expected-error {{duplicate directives 'distribute(disable)' and 'distribute(enable)'}} */ #pragma clang loop distribute(enable)
 #pragma clang loop distribute(disable)
+/* expected-error {{duplicate directives 'unroll_and_jam(disable)' and 'unroll_and_jam(enable)'}} */ #pragma clang loop unroll_and_jam(enable)
+#pragma clang loop unroll_and_jam(disable)
+/* expected-error {{duplicate directives 'vectorize_predicate(disable)' and 'vectorize_predicate(enable)'}} */ #pragma clang loop vectorize_predicate(enable)
+#pragma clang loop vectorize_predicate(disable)
   while (i-9 < Length) {
     List[i] = i;
   }
@@ -259,6 +281,10 @@ const int VV = 4;
 #pragma clang loop interleave_count(4)
 /* expected-error {{incompatible directives 'unroll(disable)' and 'unroll_count(4)'}} */ #pragma clang loop unroll(disable)
 #pragma clang loop unroll_count(4)
+/* expected-error {{incompatible directives 'unroll_and_jam(disable)' and 'unroll_and_jam_count(4)'}} */ #pragma clang loop unroll_and_jam(disable)
+#pragma clang loop unroll_and_jam_count(4)
+/* expected-error {{incompatible directives 'pipeline(disable)' and 'pipeline_initiation_interval(10)'}} */ #pragma clang loop pipeline(disable)
+#pragma clang loop pipeline_initiation_interval(10)
   while (i-10 < Length) {
     List[i] = i;
   }
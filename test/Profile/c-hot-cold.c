@@ -0,0 +1,38 @@
+// Test that functions are marked hot or cold based on the profile summary.
+
+// RUN: llvm-profdata merge %S/Inputs/c-hot-cold.proftext -o %t.profdata
+// RUN: %clang_cc1 %s -o - -disable-llvm-passes -emit-llvm -fprofile-instrument-use-path=%t.profdata | FileCheck %s
+
+int sink;
+
+// CHECK: define void @hot() #[[ATTRS:[0-9]+]] !prof !{{[0-9]+}} !section_prefix ![[HOTPREFIX:[0-9]+]]
+void hot() {
+  for (int i = 0; i < 10000000; i++)
+    sink++;
+}
+
+// CHECK: define void @warm() #[[ATTRS]] !prof !{{[0-9]+}} {
+void warm() { sink++; }
+
+// CHECK: define void @lukewarm() #[[COLD:[0-9]+]] !prof !{{[0-9]+}} !section_prefix ![[COLDPREFIX:[0-9]+]]
+void lukewarm() { sink++; }
+
+// CHECK: define void @never_called() #[[COLD]] !prof !{{[0-9]+}} !section_prefix ![[COLDPREFIX]]
+void never_called() { sink++; }
+
+// A function with an explicit section is left alone.
+// CHECK: define void @in_section() #[[ATTRS]] {{.*}}section "foo" !prof !{{[0-9]+}} {
+__attribute__((section("foo"))) void in_section() { sink++; }
+
+// CHECK: define i32 @main() #[[ATTRS]] !prof !{{[0-9]+}} {
+int main() {
+  for (int i = 0; i < 1000; i++)
+    warm();
+  hot();
+  return 0;
+}
+
+// CHECK-NOT: attributes #[[ATTRS]] = { cold
+// CHECK: attributes #[[COLD]] = { cold
+// CHECK: ![[HOTPREFIX]] = !{!"function_section_prefix", !".hot"}
+// CHECK: ![[COLDPREFIX]] = !{!"function_section_prefix", !".unlikely"}
@@ -2,6 +2,13 @@
 
 // RUN: %clang_cc1 -triple x86_64-apple-macosx10.9 -main-file-name c-indirect-call.c %s -o - -emit-llvm -fprofile-instrument=clang -mllvm -enable-value-profiling | FileCheck --check-prefix=NOEXT %s
 // RUN: %clang_cc1 -triple s390x-ibm-linux -main-file-name c-indirect-call.c %s -o - -emit-llvm -fprofile-instrument=clang -mllvm -enable-value-profiling | FileCheck --check-prefix=EXT %s
+// RUN: %clang_cc1 -triple x86_64-apple-macosx10.9 -main-file-name c-indirect-call.c %s -o - -emit-llvm -fprofile-instrument=clang -fprofile-indirect-calls | FileCheck --check-prefix=NOEXT %s
+
+// Check the value profile metadata attached when using a profile.
+
+// RUN: llvm-profdata merge %S/Inputs/c-indirect-call.proftext -o %t.profdata
+// RUN: %clang_cc1 -triple x86_64-apple-macosx10.9 -main-file-name c-indirect-call.c %s -o - -emit-llvm -fprofile-instrument-use-path=%t.profdata -fprofile-indirect-calls | FileCheck --check-prefix=USE %s
+// RUN: %clang_cc1 -triple x86_64-apple-macosx10.9 -main-file-name c-indirect-call.c %s -o - -emit-llvm -fprofile-instrument-use-path=%t.profdata | FileCheck --check-prefix=NOUSE %s
 
 void (*foo)(void);
 
@@ -14,9 +21,13 @@ int main(void) {
 // EXT-NEXT:  [[REG2:%[0-9]+]] = ptrtoint void ()* [[REG1]] to i64
 // EXT-NEXT:  call void @__llvm_profile_instrument_target(i64 [[REG2]], i8* bitcast ({{.*}}* @__profd_main to i8*), i32 zeroext 0)
 // EXT-NEXT:  call void [[REG1]]()
+// USE:  call void %{{[0-9]+}}(), !prof ![[VP:[0-9]+]]
+// NOUSE-NOT: !"VP"
   foo();
   return 0;
 }
 
 // NOEXT: declare void @__llvm_profile_instrument_target(i64, i8*, i32)
 // EXT: declare void @__llvm_profile_instrument_target(i64, i8*, i32 zeroext)
+
+// USE: ![[VP]] = !{!"VP", i32 0, i64 1010, i64 {{-?[0-9]+}}, i64 1000, i64 {{-?[0-9]+}}, i64 10}
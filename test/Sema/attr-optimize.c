@@ -0,0 +1,14 @@
+// RUN: %clang_cc1 -fsyntax-only -verify %s
+
+void f1(void) __attribute__((optimize("O3", "unroll-loops")));
+void f2(void) __attribute__((optimize("-O2", "-fno-unroll-loops")));
+void f3(void) __attribute__((optimize("Os")));
+void f4(void) __attribute__((optimize("O3", "-ffast-math"))); // expected-warning {{unsupported option '-ffast-math' in 'optimize' attribute; option ignored}}
+void f5(void) __attribute__((optimize)); // expected-error {{'optimize' attribute takes at least 1 argument}}
+void f6(void) __attribute__((optimize(3))); // expected-error {{'optimize' attribute requires a string}}
+
+int var __attribute__((optimize("O2"))); // expected-warning {{'optimize' attribute only applies to functions and methods}}
+
+// optimize("O0") behaves like optnone and optimize("Oz") like minsize.
+__attribute__((always_inline, optimize("O0"))) void f7(void) {} // expected-warning {{'always_inline' attribute ignored}} expected-note {{conflicting attribute is here}}
+__attribute__((optnone, optimize("Oz"))) void f8(void) {} // expected-warning {{'minsize' attribute ignored}} expected-note {{conflicting attribute is here}}
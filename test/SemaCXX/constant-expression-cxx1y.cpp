@@ -672,6 +672,25 @@ namespace switch_stmt {
   }
   static_assert(switch_into_for(), "");
 
+  // Check case ranges (including an empty one) in a switch which is
+  // evaluated repeatedly.
+  constexpr int classify(int n) {
+    switch (n) {
+    case -5 ... -1: return -1;
+    case 10 ... 5: return 100; // expected-warning {{empty case range specified}}
+    case 0: return 0;
+    case 1 ... 9: return 1;
+    default: return 2;
+    }
+  }
+  constexpr int sum_classify(int lo, int hi) {
+    int sum = 0;
+    for (int n = lo; n != hi; ++n)
+      sum += classify(n);
+    return sum;
+  }
+  static_assert(sum_classify(-7, 12) == 12, "");
+
   constexpr void duff_copy(char *a, const char *b, int n) {
     switch ((n - 1) % 8 + 1) {
       for ( ; n; n = (n - 1) & ~7) {
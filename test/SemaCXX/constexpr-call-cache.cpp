@@ -0,0 +1,40 @@
+// RUN: %clang_cc1 -std=c++11 -fsyntax-only -verify %s
+// RUN: %clang_cc1 -std=c++11 -fsyntax-only -verify %s -fconstexpr-cache-entries 0 -DNO_CACHE
+// RUN: %clang -std=c++11 -fsyntax-only -Xclang -verify %s -fconstexpr-cache-entries=0 -DNO_CACHE
+
+// Without memoization this makes over a billion calls, far beyond the step
+// limit. With memoization each fib(n) is evaluated only once.
+constexpr unsigned long long fib(int n) {
+#ifdef NO_CACHE
+  // expected-note@+3 {{step limit}}
+  // expected-note@+2 0+{{in call to}}
+#endif
+  return n < 2 ? n : fib(n - 1) + fib(n - 2);
+}
+
+#ifdef NO_CACHE
+// expected-note@+2 0+{{skipping}}
+// expected-note@+1 {{in call to}}
+static_assert(fib(45) == 1134903170ULL, ""); // expected-error {{constant}}
+#else
+static_assert(fib(45) == 1134903170ULL, "");
+static_assert(fib(90) == 2880067194370816120ULL, "");
+#endif
+
+// Calls that are not cleanly evaluated are not memoized: the second call
+// produces the same diagnostic as the first.
+constexpr int div(int a, int b) { return a / b; } // expected-note 2{{division by zero}}
+static_assert(div(1, 0), ""); // expected-error {{constant}} expected-note {{in call}}
+static_assert(div(1, 0), ""); // expected-error {{constant}} expected-note {{in call}}
+
+// Overflow found while checking an initializer for overflow is only warned
+// about, and evaluation continues with the wrapped value; that value must not
+// be memoized.
+constexpr int mul(int a, int b) {
+  // expected-warning@+2 2{{overflow in expression; result is 0 with type 'int'}}
+  // expected-note@+1 {{value 1099511627776 is outside the range of representable values of type 'int'}}
+  return a * b;
+}
+int x = mul(1 << 20, 1 << 20) + 1;
+static_assert(mul(1 << 20, 1 << 20) == 0, ""); // expected-error {{constant}} expected-note {{in call}}
+int y = mul(1 << 20, 1 << 20) + 1;
@@ -658,3 +658,18 @@ namespace StringLiteralToCharAmbiguity {
   // expected-note@-5 {{candidate function}}
 #endif
 }
+
+namespace SharedParameterTypes {
+  // Candidates with the same parameter types reuse the conversion sequences
+  // computed for earlier candidates; make sure every candidate still sees the
+  // right (possibly ambiguous or bad) conversion.
+  struct X { operator int(); operator long(); };
+  int &f(double, int);
+  float &f(double, char *);
+  void g(X x) { int &r = f(x, 0); }
+
+  struct A { A(int); };
+  void h(int, A); // expected-note {{candidate function not viable: no known conversion from 'char *' to 'SharedParameterTypes::A' for 2nd argument}}
+  void h(long, A); // expected-note {{candidate function not viable: no known conversion from 'char *' to 'SharedParameterTypes::A' for 2nd argument}}
+  void i(char *p) { h(0, p); } // expected-error {{no matching function for call to 'h'}}
+}
@@ -82,6 +82,12 @@ static unsigned getDefaultParsingOptions() {
     options |= CXTranslationUnit_CreatePreambleOnFirstParse;
   if (getenv("CINDEXTEST_KEEP_GOING"))
     options |= CXTranslationUnit_KeepGoing;
+  if (getenv("CINDEXTEST_SKIP_UNCHANGED_FUNCTION_BODIES"))
+    options |= CXTranslationUnit_SkipUnchangedFunctionBodies;
+  if (getenv("CINDEXTEST_BUILD_PREAMBLE_IN_BACKGROUND"))
+    options |= CXTranslationUnit_BuildPreambleInBackground;
+  if (getenv("CINDEXTEST_STORE_PREAMBLE_IN_MEMORY"))
+    options |= CXTranslationUnit_StorePreambleInMemory;
 
   return options;
 }
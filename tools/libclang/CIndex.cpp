@@ -3327,6 +3327,12 @@ clang_parseTranslationUnit_Impl(CXIndex CIdx, const char *source_filename,
   bool SkipFunctionBodies = options & CXTranslationUnit_SkipFunctionBodies;
   bool SingleFileParse = options & CXTranslationUnit_SingleFileParse;
   bool ForSerialization = options & CXTranslationUnit_ForSerialization;
+  bool SkipUnchangedFunctionBodies =
+      options & CXTranslationUnit_SkipUnchangedFunctionBodies;
+  bool BuildPreambleInBackground =
+      options & CXTranslationUnit_BuildPreambleInBackground;
+  bool StorePreambleInMemory =
+      options & CXTranslationUnit_StorePreambleInMemory;
 
   // Configure the diagnostics.
   IntrusiveRefCntPtr<DiagnosticsEngine>
@@ -3412,6 +3418,8 @@ clang_parseTranslationUnit_Impl(CXIndex CIdx, const char *source_filename,
       TUKind, CacheCodeCompletionResults, IncludeBriefCommentsInCodeCompletion,
       /*AllowPCHWithCompilerErrors=*/true, SkipFunctionBodies, SingleFileParse,
       /*UserFilesAreVolatile=*/true, ForSerialization,
+      SkipUnchangedFunctionBodies, BuildPreambleInBackground,
+      StorePreambleInMemory,
       CXXIdx->getPCHContainerOperations()->getRawReader().getFormat(),
       &ErrUnit));
 
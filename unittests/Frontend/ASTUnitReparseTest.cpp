@@ -0,0 +1,325 @@
+//===- unittests/Frontend/ASTUnitReparseTest.cpp - ASTUnit reparse tests --===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// Tests and latency measurements for reparsing an ASTUnit with
+// setSkipUnchangedFunctionBodies, and tests for the preamble options that
+// LoadFromCommandLine applies to the initial parse and for building preambles
+// in the background.
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/AST/Decl.h"
+#include "clang/Frontend/ASTUnit.h"
+#include "clang/Frontend/CompilerInstance.h"
+#include "clang/Frontend/PCHContainerOperations.h"
+#include "clang/Serialization/ASTReader.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/Chrono.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+#include <chrono>
+#include <ctime>
+
+using namespace llvm;
+using namespace clang;
+
+namespace {
+
+const unsigned NumFunctions = 2000;
+
+/// Build a main file with many unrelated functions, followed by the one that
+/// the edits change.
+std::string makeSource(unsigned EditedValue) {
+  std::string Source;
+  raw_string_ostream OS(Source);
+  for (unsigned I = 0; I != NumFunctions; ++I)
+    OS << "int f" << I << "(int x) {\n"
+       << "  int y = x * " << I << ";\n"
+       << "  for (int i = 0; i < x; ++i)\n"
+       << "    y += i ^ " << I << ";\n"
+       << "  return y;\n"
+       << "}\n";
+  OS << "int edited() { return " << EditedValue << "; }\n";
+  return OS.str();
+}
+
+ASTUnit::RemappedFile remapMainFile(StringRef Source) {
+  return ASTUnit::RemappedFile(
+      "main.cpp", MemoryBuffer::getMemBufferCopy(Source, "main.cpp").release());
+}
+
+ASTUnit::RemappedFile remapMainFile(unsigned EditedValue) {
+  return remapMainFile(makeSource(EditedValue));
+}
+
+std::unique_ptr<ASTUnit> loadMainFile(StringRef Source) {
+  const char *Args[] = {"clang", "-fsyntax-only", "main.cpp"};
+  auto PCHContainerOps = std::make_shared<PCHContainerOperations>();
+  IntrusiveRefCntPtr<DiagnosticsEngine> Diags =
+      CompilerInstance::createDiagnostics(new DiagnosticOptions());
+  ASTUnit::RemappedFile MainFile = remapMainFile(Source);
+  return std::unique_ptr<ASTUnit>(ASTUnit::LoadFromCommandLine(
+      std::begin(Args), std::end(Args), PCHContainerOps, Diags, "",
+      /*OnlyLocalDecls=*/false, /*CaptureDiagnostics=*/true, MainFile));
+}
+
+std::unique_ptr<ASTUnit> loadMainFile() { return loadMainFile(makeSource(0)); }
+
+/// Reparse \p AST with \p Source as the new main file.
+void reparseMainFile(ASTUnit &AST, StringRef Source) {
+  ASTUnit::RemappedFile MainFile = remapMainFile(Source);
+  EXPECT_FALSE(
+      AST.Reparse(std::make_shared<PCHContainerOperations>(), MainFile));
+}
+
+/// Reparse \p AST after editing the last function, and return how long the
+/// reparse took, in microseconds.
+int64_t reparseAfterEdit(ASTUnit &AST, unsigned EditedValue) {
+  ASTUnit::RemappedFile MainFile = remapMainFile(EditedValue);
+  auto Start = std::chrono::steady_clock::now();
+  EXPECT_FALSE(
+      AST.Reparse(std::make_shared<PCHContainerOperations>(), MainFile));
+  auto End = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::microseconds>(End - Start)
+      .count();
+}
+
+unsigned countSkippedBodies(ASTUnit &AST) {
+  unsigned NumSkipped = 0;
+  for (auto I = AST.top_level_begin(), E = AST.top_level_end(); I != E; ++I)
+    if (const auto *FD = dyn_cast<FunctionDecl>(*I))
+      NumSkipped += FD->hasSkippedBody();
+  return NumSkipped;
+}
+
+TEST(ASTUnitReparseTest, SkipUnchangedFunctionBodies) {
+  std::unique_ptr<ASTUnit> Full = loadMainFile();
+  std::unique_ptr<ASTUnit> Skipping = loadMainFile();
+  ASSERT_TRUE(Full && Skipping);
+  Skipping->setSkipUnchangedFunctionBodies(true);
+
+  int64_t FullTime = 0, SkippingTime = 0;
+  for (unsigned Edit = 1; Edit <= 3; ++Edit) {
+    FullTime += reparseAfterEdit(*Full, Edit);
+    SkippingTime += reparseAfterEdit(*Skipping, Edit);
+
+    EXPECT_EQ(0U, countSkippedBodies(*Full));
+    EXPECT_EQ(NumFunctions, countSkippedBodies(*Skipping));
+    EXPECT_EQ(0U, Skipping->stored_diag_size());
+  }
+
+  // Report the latencies rather than comparing them, so that the test does
+  // not depend on the load of the machine running it.
+  RecordProperty("FullReparseMicroseconds", static_cast<int>(FullTime));
+  RecordProperty("SkippingReparseMicroseconds",
+                 static_cast<int>(SkippingTime));
+}
+
+TEST(ASTUnitReparseTest, MacroChangeInEditedBody) {
+  std::unique_ptr<ASTUnit> AST = loadMainFile("#define VALUE 1\n"
+                                              "int edited() {\n"
+                                              "  return 0;\n"
+                                              "  // Placeholder.\n"
+                                              "}\n"
+                                              "int later() {\n"
+                                              "  return VALUE;\n"
+                                              "}\n");
+  ASSERT_TRUE(AST);
+  AST->setSkipUnchangedFunctionBodies(true);
+
+  reparseMainFile(*AST, "#define VALUE 1\n"
+                        "int edited() {\n"
+                        "  return 1;\n"
+                        "  // Placeholder.\n"
+                        "}\n"
+                        "int later() {\n"
+                        "  return VALUE;\n"
+                        "}\n");
+  EXPECT_EQ(1U, countSkippedBodies(*AST));
+  EXPECT_EQ(0U, AST->stored_diag_size());
+
+  // Undefining the macro changes the meaning of the body that follows.
+  reparseMainFile(*AST, "#define VALUE 1\n"
+                        "int edited() {\n"
+                        "  return 1;\n"
+                        "#undef VALUE\n"
+                        "}\n"
+                        "int later() {\n"
+                        "  return VALUE;\n"
+                        "}\n");
+  EXPECT_EQ(0U, countSkippedBodies(*AST));
+  EXPECT_EQ(1U, AST->stored_diag_size());
+}
+
+TEST(ASTUnitReparseTest, LineChangeInEditedBody) {
+  std::unique_ptr<ASTUnit> AST =
+      loadMainFile("int edited() {\n"
+                   "  return 0;\n"
+                   "}\n"
+                   "void later() { static_assert(__LINE__ == 4, \"\"); }\n");
+  ASSERT_TRUE(AST);
+  AST->setSkipUnchangedFunctionBodies(true);
+
+  // Adding a line moves the body that follows, which changes its __LINE__.
+  reparseMainFile(*AST,
+                  "int edited() {\n"
+                  "  return 0;\n"
+                  "\n"
+                  "}\n"
+                  "void later() { static_assert(__LINE__ == 4, \"\"); }\n");
+  EXPECT_EQ(0U, countSkippedBodies(*AST));
+  EXPECT_EQ(1U, AST->stored_diag_size());
+}
+
+TEST(ASTUnitReparseTest, InMemoryPreambleOnFirstParse) {
+  const char *Args[] = {"clang", "-fsyntax-only", "main.cpp"};
+  ASTUnit::RemappedFile Files[] = {
+      {"header.h",
+       MemoryBuffer::getMemBufferCopy("int f();\n", "header.h").release()},
+      {"main.cpp", MemoryBuffer::getMemBufferCopy(
+                       "#include \"header.h\"\nint g() { return f(); }\n",
+                       "main.cpp")
+                       .release()}};
+  auto PCHContainerOps = std::make_shared<PCHContainerOperations>();
+  IntrusiveRefCntPtr<DiagnosticsEngine> Diags =
+      CompilerInstance::createDiagnostics(new DiagnosticOptions());
+  std::unique_ptr<ASTUnit> AST(ASTUnit::LoadFromCommandLine(
+      std::begin(Args), std::end(Args), PCHContainerOps, Diags, "",
+      /*OnlyLocalDecls=*/false, /*CaptureDiagnostics=*/true, Files,
+      /*RemappedFilesKeepOriginalName=*/true,
+      /*PrecompilePreambleAfterNParses=*/1, TU_Complete,
+      /*CacheCodeCompletionResults=*/false,
+      /*IncludeBriefCommentsInCodeCompletion=*/false,
+      /*AllowPCHWithCompilerErrors=*/false, /*SkipFunctionBodies=*/false,
+      /*SingleFileParse=*/false, /*UserFilesAreVolatile=*/false,
+      /*ForSerialization=*/false, /*SkipUnchangedFunctionBodies=*/false,
+      /*BuildPreambleInBackground=*/false, /*StorePreambleInMemory=*/true));
+  ASSERT_TRUE(AST);
+  EXPECT_EQ(0U, AST->stored_diag_size());
+
+  // The preamble built by the initial parse must already be read from memory.
+  serialization::ModuleManager &Modules =
+      AST->getASTReader()->getModuleManager();
+  unsigned NumPreambles = 0;
+  Modules.visit([&](serialization::ModuleFile &M) {
+    if (M.Kind == serialization::MK_Preamble) {
+      ++NumPreambles;
+      EXPECT_TRUE(Modules.getPCMCache().lookupBuffer(M.FileName));
+      EXPECT_FALSE(sys::fs::exists(M.FileName));
+    }
+    return false;
+  });
+  EXPECT_EQ(1U, NumPreambles);
+}
+
+#if LLVM_ENABLE_THREADS
+/// Tests of reparsing with a stale preamble, whose files are written to disk
+/// with increasing modification times.
+class StalePreambleTest : public ::testing::Test {
+protected:
+  SmallString<256> TestDir;
+  sys::TimePoint<> ModTime;
+
+  void SetUp() override {
+    ASSERT_FALSE(sys::fs::createUniqueDirectory("stale-preamble-test",
+                                                TestDir));
+    ModTime = sys::toTimePoint(std::time(nullptr)) - std::chrono::hours(1);
+  }
+
+  void TearDown() override { sys::fs::remove_directories(TestDir); }
+
+  std::string getPath(StringRef Name) {
+    SmallString<256> Path(TestDir);
+    sys::path::append(Path, Name);
+    return Path.str();
+  }
+
+  /// Write \p Name, making sure that its modification time changes even if
+  /// it is rewritten within the same second.
+  void writeFile(StringRef Name, StringRef Contents) {
+    int FD;
+    ASSERT_FALSE(sys::fs::openFileForWrite(getPath(Name), FD, sys::fs::F_None));
+    raw_fd_ostream OS(FD, /*shouldClose=*/true);
+    OS << Contents;
+    OS.flush();
+    ModTime += std::chrono::seconds(1);
+    ASSERT_FALSE(sys::fs::setLastModificationAndAccessTime(FD, ModTime));
+  }
+
+  std::unique_ptr<ASTUnit> loadMainFile() {
+    std::string MainPath = getPath("main.cpp");
+    const char *Args[] = {"clang", "-fsyntax-only", MainPath.c_str()};
+    IntrusiveRefCntPtr<DiagnosticsEngine> Diags =
+        CompilerInstance::createDiagnostics(new DiagnosticOptions());
+    return std::unique_ptr<ASTUnit>(ASTUnit::LoadFromCommandLine(
+        std::begin(Args), std::end(Args),
+        std::make_shared<PCHContainerOperations>(), Diags, "",
+        /*OnlyLocalDecls=*/false, /*CaptureDiagnostics=*/true, None,
+        /*RemappedFilesKeepOriginalName=*/true,
+        /*PrecompilePreambleAfterNParses=*/1, TU_Complete,
+        /*CacheCodeCompletionResults=*/false,
+        /*IncludeBriefCommentsInCodeCompletion=*/false,
+        /*AllowPCHWithCompilerErrors=*/false, /*SkipFunctionBodies=*/false,
+        /*SingleFileParse=*/false, /*UserFilesAreVolatile=*/false,
+        /*ForSerialization=*/false, /*SkipUnchangedFunctionBodies=*/false,
+        /*BuildPreambleInBackground=*/true));
+  }
+
+  void reparse(ASTUnit &AST) {
+    EXPECT_FALSE(AST.Reparse(std::make_shared<PCHContainerOperations>()));
+  }
+};
+
+TEST_F(StalePreambleTest, DiagnosticInChangedHeader) {
+  writeFile("header.h", "int f(int);\n");
+  writeFile("main.cpp", "#include \"header.h\"\nint g() { return f(); }\n");
+  std::unique_ptr<ASTUnit> AST = loadMainFile();
+  ASSERT_TRUE(AST);
+  EXPECT_EQ(2U, AST->stored_diag_size());
+
+  // The header keeps its size, so the old preamble is still used while the
+  // new one is built. Its note resolves into the changed header, which the
+  // PCH reader accepts.
+  writeFile("header.h", "int f(   );\n");
+  reparse(*AST);
+  ASSERT_EQ(2U, AST->stored_diag_size());
+  const StoredDiagnostic &Note = AST->stored_diag_begin()[1];
+  EXPECT_EQ(DiagnosticsEngine::Note, Note.getLevel());
+  PresumedLoc PLoc =
+      Note.getLocation().getManager().getPresumedLoc(Note.getLocation());
+  ASSERT_TRUE(PLoc.isValid());
+  EXPECT_EQ("header.h", sys::path::filename(PLoc.getFilename()));
+  EXPECT_EQ(1U, PLoc.getLine());
+  EXPECT_EQ(5U, PLoc.getColumn());
+
+  // The next reparse picks up the new preamble.
+  AST->waitForBackgroundPreamble();
+  reparse(*AST);
+  EXPECT_EQ(0U, AST->stored_diag_size());
+}
+
+TEST_F(StalePreambleTest, HeaderSizeChange) {
+  writeFile("header.h", "int f(int);\n");
+  writeFile("main.cpp", "#include \"header.h\"\nint g() { return f(); }\n");
+  std::unique_ptr<ASTUnit> AST = loadMainFile();
+  ASSERT_TRUE(AST);
+  EXPECT_EQ(2U, AST->stored_diag_size());
+
+  // The PCH reader would reject the header, so the preamble is rebuilt
+  // synchronously instead.
+  writeFile("header.h", "int f();\n");
+  reparse(*AST);
+  EXPECT_EQ(0U, AST->stored_diag_size());
+}
+#endif
+
+} // end anonymous namespace
@@ -0,0 +1,78 @@
+//===- unittests/Frontend/CompactTypeSourceInfoTest.cpp -------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// Memory measurements for -fcompact-type-source-info.
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/AST/ASTContext.h"
+#include "clang/Frontend/ASTUnit.h"
+#include "clang/Frontend/CompilerInstance.h"
+#include "clang/Frontend/PCHContainerOperations.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace clang;
+
+namespace {
+
+/// Build a main file with many declarations of several declarators each.
+std::string makeSource() {
+  std::string Source;
+  raw_string_ostream OS(Source);
+  OS << "struct Point { int x, y, z; };\n";
+  for (unsigned I = 0; I != 1000; ++I) {
+    OS << "struct S" << I << " { int a, b, c, d; Point p, q; };\n"
+       << "int f" << I << "() {\n"
+       << "  int i, j, k;\n"
+       << "  Point u, v;\n"
+       << "  return i + j + k + u.x + v.y;\n"
+       << "}\n";
+  }
+  return OS.str();
+}
+
+/// Parse the source from makeSource() and return the number of bytes that
+/// its ASTContext allocated.
+size_t getASTAllocatedMemory(bool Compact) {
+  std::vector<const char *> Args = {"clang", "-fsyntax-only"};
+  if (Compact) {
+    Args.push_back("-Xclang");
+    Args.push_back("-fcompact-type-source-info");
+  }
+  Args.push_back("main.cpp");
+
+  ASTUnit::RemappedFile MainFile(
+      "main.cpp",
+      MemoryBuffer::getMemBufferCopy(makeSource(), "main.cpp").release());
+  IntrusiveRefCntPtr<DiagnosticsEngine> Diags =
+      CompilerInstance::createDiagnostics(new DiagnosticOptions());
+  std::unique_ptr<ASTUnit> AST(ASTUnit::LoadFromCommandLine(
+      Args.data(), Args.data() + Args.size(),
+      std::make_shared<PCHContainerOperations>(), Diags, "",
+      /*OnlyLocalDecls=*/false, /*CaptureDiagnostics=*/true, MainFile));
+  EXPECT_TRUE(AST);
+  if (!AST)
+    return 0;
+  EXPECT_EQ(0U, AST->stored_diag_size());
+  return AST->getASTContext().getASTAllocatedMemory();
+}
+
+TEST(CompactTypeSourceInfoTest, ASTContextMemory) {
+  size_t DefaultBytes = getASTAllocatedMemory(/*Compact=*/false);
+  size_t CompactBytes = getASTAllocatedMemory(/*Compact=*/true);
+  EXPECT_LT(CompactBytes, DefaultBytes);
+
+  RecordProperty("DefaultASTContextBytes", static_cast<int>(DefaultBytes));
+  RecordProperty("CompactASTContextBytes", static_cast<int>(CompactBytes));
+}
+
+} // end anonymous namespace
@@ -546,6 +546,107 @@ TEST_F(LibclangReparseTest, ReparseWithModule) {
   EXPECT_EQ(0U, clang_getNumDiagnostics(ClangTU));
 }
 
+TEST_F(LibclangReparseTest, ReparseWithBackgroundPreamble) {
+  const char *HeaderTop = "#ifndef H\n#define H\nstruct Foo { int bar;";
+  const char *HeaderBottom = "\n};\n#endif\n";
+  const char *CppFile = "#include \"HeaderFile.h\"\nint main() {"
+                         " Foo foo; foo.bar = 7; foo.baz = 8; }\n";
+  std::string HeaderName = "HeaderFile.h";
+  std::string CppName = "CppFile.cpp";
+  WriteFile(CppName, CppFile);
+  WriteFile(HeaderName, std::string(HeaderTop) + HeaderBottom);
+
+  ClangTU = clang_parseTranslationUnit(
+      Index, CppName.c_str(), nullptr, 0, nullptr, 0,
+      TUFlags | CXTranslationUnit_BuildPreambleInBackground);
+  EXPECT_EQ(1U, clang_getNumDiagnostics(ClangTU));
+
+  // Build the preamble.
+  ASSERT_TRUE(ReparseTU(0, nullptr /* No unsaved files. */));
+  EXPECT_EQ(1U, clang_getNumDiagnostics(ClangTU));
+
+  std::string NewHeaderContents =
+      std::string(HeaderTop) + "int baz;" + HeaderBottom;
+  WriteFile(HeaderName, NewHeaderContents);
+
+  // The header changed size, so the old preamble cannot be loaded in the
+  // meantime and the reparse after the fix rebuilds it right away.
+  ASSERT_TRUE(ReparseTU(0, nullptr /* No unsaved files. */));
+  EXPECT_EQ(0U, clang_getNumDiagnostics(ClangTU));
+}
+
+TEST_F(LibclangReparseTest, ReparseSkipsUnchangedFunctionBodies) {
+  std::string CppName = "main.cpp";
+  WriteFile(CppName, "int f() { return 1; }\nint g() { return 2; }\n");
+
+  ClangTU = clang_parseTranslationUnit(
+      Index, CppName.c_str(), nullptr, 0, nullptr, 0,
+      TUFlags | CXTranslationUnit_SkipUnchangedFunctionBodies);
+  EXPECT_EQ(0U, clang_getNumDiagnostics(ClangTU));
+
+  unsigned NumBodies = 0;
+  auto CountBodies = [&](CXCursor C, CXCursor) {
+    if (clang_getCursorKind(C) == CXCursor_CompoundStmt)
+      ++NumBodies;
+    return CXChildVisit_Recurse;
+  };
+  Traverse(CountBodies);
+  EXPECT_EQ(2U, NumBodies);
+
+  // Introduce an error in g. Only g's body is parsed again.
+  WriteFile(CppName, "int f() { return 1; }\nint g() { return x; }\n");
+  ASSERT_TRUE(ReparseTU(0, nullptr /* No unsaved files. */));
+  EXPECT_EQ(1U, clang_getNumDiagnostics(ClangTU));
+  NumBodies = 0;
+  Traverse(CountBodies);
+  EXPECT_EQ(1U, NumBodies);
+
+  // Fix the error; f's body is still skipped.
+  WriteFile(CppName, "int f() { return 1; }\nint g() { return 3; }\n");
+  ASSERT_TRUE(ReparseTU(0, nullptr /* No unsaved files. */));
+  EXPECT_EQ(0U, clang_getNumDiagnostics(ClangTU));
+  NumBodies = 0;
+  Traverse(CountBodies);
+  EXPECT_EQ(1U, NumBodies);
+
+  // Changes outside of a function body cause everything to be parsed again.
+  WriteFile(CppName, "int f() { return 1; }\n\nint g() { return 3; }\n");
+  ASSERT_TRUE(ReparseTU(0, nullptr /* No unsaved files. */));
+  EXPECT_EQ(0U, clang_getNumDiagnostics(ClangTU));
+  NumBodies = 0;
+  Traverse(CountBodies);
+  EXPECT_EQ(2U, NumBodies);
+}
+
+TEST_F(LibclangReparseTest, ReparseKeepsBodiesUsingInternalDecls) {
+  std::string CppName = "main.cpp";
+  const char *Args[] = {"-Wunused-function"};
+  WriteFile(CppName, "static int helper() { return 1; }\n"
+                     "int f() { return helper(); }\n"
+                     "int g() { return 2; }\n");
+
+  ClangTU = clang_parseTranslationUnit(
+      Index, CppName.c_str(), Args, 1, nullptr, 0,
+      TUFlags | CXTranslationUnit_SkipUnchangedFunctionBodies);
+  EXPECT_EQ(0U, clang_getNumDiagnostics(ClangTU));
+
+  // f's body uses helper, so it is parsed again even though it did not
+  // change, and helper is not reported as unused. Only helper's own body is
+  // skipped.
+  WriteFile(CppName, "static int helper() { return 1; }\n"
+                     "int f() { return helper(); }\n"
+                     "int g() { return 3; }\n");
+  ASSERT_TRUE(ReparseTU(0, nullptr /* No unsaved files. */));
+  EXPECT_EQ(0U, clang_getNumDiagnostics(ClangTU));
+  unsigned NumBodies = 0;
+  Traverse([&](CXCursor C, CXCursor) {
+    if (clang_getCursorKind(C) == CXCursor_CompoundStmt)
+      ++NumBodies;
+    return CXChildVisit_Recurse;
+  });
+  EXPECT_EQ(2U, NumBodies);
+}
+
 TEST_F(LibclangReparseTest, clang_parseTranslationUnit2FullArgv) {
   // Provide a fake GCC 99.9.9 standard library that always overrides any local
   // GCC installation.